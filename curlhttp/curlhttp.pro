@@ -2,39 +2,75 @@ CONFIG += console c++17
 CONFIG -= app_bundle qt
 
 unix:QMAKE_CXXFLAGS += -std=c++17
-unix:LIBS += -lcurl
+unix:LIBS += -lcurl -lz
+
+curlhttp_brotli{
+    DEFINES += CURLHTTP_USE_BROTLI
+    unix:LIBS += -lbrotlidec
+}
+
+curlhttp_zstd{
+    DEFINES += CURLHTTP_USE_ZSTD
+    unix:LIBS += -lzstd
+}
 
 SOURCES += \
         main.cpp
 
 HEADERS += \
     curlhttp/async_handle.hpp \
+    curlhttp/async_metrics.hpp \
     curlhttp/buffer_t.hpp \
+    curlhttp/callback_hooks.hpp \
+    curlhttp/compressed_t.hpp \
     curlhttp/curl_base.hpp \
     curlhttp/curl_error.hpp \
     curlhttp/curl_handle.hpp \
     curlhttp/curlhttp.hpp \
+    curlhttp/debug_ring.hpp \
+    curlhttp/decoding_writer.hpp \
     curlhttp/default_reader.hpp \
     curlhttp/default_seeker.hpp \
     curlhttp/default_writer.hpp \
     curlhttp/detail.hpp \
+    curlhttp/download_checkpoint_t.hpp \
     curlhttp/field_t.hpp \
+    curlhttp/file_sink_t.hpp \
+    curlhttp/file_t.hpp \
+    curlhttp/header_block_t.hpp \
+    curlhttp/header_names.hpp \
+    curlhttp/header_set_t.hpp \
     curlhttp/html.hpp \
     curlhttp/http_manager.hpp \
     curlhttp/http_request.hpp \
     curlhttp/json.hpp \
+    curlhttp/latency_histogram.hpp \
+    curlhttp/mapped_file_t.hpp \
     curlhttp/method_t.hpp \
     curlhttp/mime_data.hpp \
     curlhttp/mime_holder.hpp \
     curlhttp/multipart_request.hpp \
+    curlhttp/multipart_upload.hpp \
+    curlhttp/multiplex.hpp \
+    curlhttp/notifier_t.hpp \
     curlhttp/nullbuf_t.hpp \
     curlhttp/option_t.hpp \
     curlhttp/path_t.hpp \
+    curlhttp/percent_encoding.hpp \
+    curlhttp/producer_t.hpp \
     curlhttp/query_t.hpp \
+    curlhttp/resolve_cache.hpp \
     curlhttp/resource_manager.hpp \
     curlhttp/response_t.hpp \
+    curlhttp/result_t.hpp \
+    curlhttp/ring_buffer_t.hpp \
+    curlhttp/segmented_download.hpp \
+    curlhttp/share_snapshot.hpp \
     curlhttp/size_getter.hpp \
+    curlhttp/spsc_queue.hpp \
     curlhttp/status_code.hpp \
+    curlhttp/tracing.hpp \
+    curlhttp/transfer_info_t.hpp \
     curlhttp/url_t.hpp \
     curlhttp/utility.hpp
 
@@ -2,8 +2,10 @@
 #define CURLHTTP_ASYNC_HANDLE_HPP
 
 
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <thread>
 
 #ifndef _WIN32
@@ -13,7 +15,9 @@
 #endif
 
 #include "detail.hpp"
+#include "async_metrics.hpp"
 #include "curl_base.hpp"
+#include "multiplex.hpp"
 #include "option_t.hpp"
 
 namespace curlhttp{
@@ -36,11 +40,13 @@ namespace curlhttp{
             std::function<void()> done_callback;
             std::vector<easy_option_ptr> default_options;
             bool throw_easy_errors{true};
+            bool throw_callback_exceptions{true};
 
             void apply(curl_base& ref) const{
                 ref.easy_error_callback = easy_error_callback;
                 ref.done_callback = done_callback;
                 ref.throw_easy_errors = throw_easy_errors;
+                ref.throw_callback_exceptions = throw_callback_exceptions;
 
                 for(auto& opt : default_options)
                     opt->apply(ref);
@@ -53,11 +59,12 @@ namespace curlhttp{
         prototype_t prototype;
         error_callback_t multi_error_callback;
         done_callback_t done_callback;
+        std::function<void()> loop_callback;
         autoremove_t autoremove{autoremove_t::none};
         bool throw_multi_errors = true;
 
         async_handle()
-            : handle{curl_multi_init()} {}
+            : handle{curl_multi_init(), detail::CURLM_deleter{}} {}
 
         async_handle(async_handle&& ) = default;
         async_handle& operator= (async_handle&& ) = default;
@@ -79,7 +86,10 @@ namespace curlhttp{
 
             if((code = curl_multi_add_handle(handle.get(), request.native())) == CURLM_OK){
                 requests[request.native()] = {std::addressof(request), {}};
+                request.suspended = suspended.get();
+                request.waker->attach(handle);
                 apply(request);
+                join(request);
             }
 
             else
@@ -96,7 +106,10 @@ namespace curlhttp{
                     std::bind(std::forward<Function>(callback), std::ref(request))
                 };
 
+                request.suspended = suspended.get();
+                request.waker->attach(handle);
                 apply(request);
+                join(request);
             }
 
             else
@@ -108,64 +121,49 @@ namespace curlhttp{
         }
 
         virtual void remove(curl_base& request){
-            if(curl_multi_remove_handle(handle.get(), request.native()) == CURLM_OK)
-                requests.erase(request.native());
+            remove(request.native());
         }
 
         virtual void init(){
             for(auto& item : requests)
-                item.second.request->init();
+                init(*item.second.request);
+        }
+
+        virtual void init(curl_base& request){
+            request.init();
         }
 
         virtual void perform(){
-            struct timeval timeout;
+            int still_running;
 
-            fd_set fdread;
-            fd_set fdwrite;
-            fd_set fdexcep;
+            struct guard_t{
+                bool& flag;
 
-            long ms = -1;
-            int still_running;
-            int maxfd = -1;
-            int rc;
+                ~guard_t(){
+                    flag = false;
+                }
+            } guard{performing};
 
             init();
-            multi_error_checker(curl_multi_perform, &still_running);
-            process_events();
+            joining.clear();
+            pending = requests.size();
+            performing = true;
+            drive(still_running);
 
             while(still_running > 0){
-                FD_ZERO(&fdread);
-                FD_ZERO(&fdwrite);
-                FD_ZERO(&fdexcep);
-
-                timeout.tv_sec = 1;
-                timeout.tv_usec = 0;
-
-                multi_error_checker(curl_multi_timeout, &ms);
+                metrics->loop_iterations.add();
 
-                if(ms >= 0){
-                    timeout.tv_sec = ms / 1000;
+                if(loop_callback){
+                    loop_callback();
+                    drive(still_running);
 
-                    if(timeout.tv_sec > 1)
-                        timeout.tv_sec = 1;
-                    else
-                        timeout.tv_usec = (ms % 1000) * 1000;
+                    if(still_running <= 0)
+                        break;
                 }
 
-                multi_error_checker(curl_multi_fdset, &fdread, &fdwrite, &fdexcep, &maxfd);
-
-                if(maxfd < 0){
-                    struct timeval wait = {0, 100 * 1000};
-                    rc = select(0, 0, 0, 0, &wait);
-                }
-
-                else
-                    rc = select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &timeout);
-
-                if(rc > 0){
-                    multi_error_checker(curl_multi_perform, &still_running);
-                    process_events();
-                }
+                wait();
+                resume_suspended();
+                drive(still_running);
             }
         }
 
@@ -173,24 +171,58 @@ namespace curlhttp{
             while(requests.size())
                 remove(*requests.begin()->second.request);
 
-            handle.reset(curl_multi_init());
+            handle.reset(curl_multi_init(), detail::CURLM_deleter{});
             prototype = {};
+            connections->clear();
 
             multi_error_callback = {};
             done_callback = {};
+            loop_callback = {};
 
             autoremove = autoremove_t::none;
             throw_multi_errors = true;
         }
 
+        void set_multiplexing(const multiplex_t& settings){
+            set_option(CURLMOPT_PIPELINING, settings.http_version >= CURL_HTTP_VERSION_2_0 ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+            set_option(CURLMOPT_MAX_HOST_CONNECTIONS, settings.max_host_connections);
+            set_option(CURLMOPT_MAX_TOTAL_CONNECTIONS, settings.max_total_connections);
+
+#if LIBCURL_VERSION_NUM >= 0x074300
+            set_option(CURLMOPT_MAX_CONCURRENT_STREAMS, settings.max_concurrent_streams);
+#endif
+
+            set_default_option(CURLOPT_HTTP_VERSION, settings.http_version);
+            set_default_option(CURLOPT_PIPEWAIT, settings.pipewait ? 1L : 0L);
+        }
+
+        const connection_stats& get_connection_stats() const{
+            return *connections;
+        }
+
+        virtual void set_throw_errors(bool enable){
+            throw_multi_errors = enable;
+            prototype.throw_easy_errors = enable;
+            prototype.throw_callback_exceptions = enable;
+        }
+
+        const async_metrics& get_metrics() const{
+            return *metrics;
+        }
+
         template<typename T>
         void reuse(T& request){
+            unsuspend(request);
             multi_error_checker(curl_multi_remove_handle, request.native());
             multi_error_checker(curl_multi_add_handle, request.native());
+            join(request);
         }
 
         void reuse(){
+            suspended->clear();
+
             for(auto& p : requests){
+                p.second.request->paused = false;
                 multi_error_checker(curl_multi_remove_handle, p.second.request->native());
                 multi_error_checker(curl_multi_add_handle, p.second.request->native());
             }
@@ -199,8 +231,93 @@ namespace curlhttp{
     protected:
         std::unordered_map<CURL*, settings_t> requests;
 
+        void perform_only(const std::vector<curl_base*>& subset){
+            if(performing)
+                throw curl_multi_error{make_multi_error_code(CURLM_RECURSIVE_API_CALL)};
+
+            struct guard_t{
+                async_handle& self;
+                std::unordered_map<CURL*, settings_t> parked;
+                done_callback_t callback;
+
+                ~guard_t(){
+                    for(auto& item : parked){
+                        if(curl_multi_add_handle(self.handle.get(), item.first) == CURLM_OK)
+                            self.requests.insert(std::move(item));
+                        else{
+                            item.second.request->suspended = nullptr;
+                            item.second.request->waker->attach({});
+                        }
+                    }
+
+                    self.done_callback = std::move(callback);
+                }
+            } guard{*this, {}, std::move(done_callback)};
+
+            for(auto it = requests.begin(); it != requests.end();){
+                if(std::find(subset.begin(), subset.end(), it->second.request) != subset.end()){
+                    ++it;
+                    continue;
+                }
+
+                multi_error_checker(curl_multi_remove_handle, it->first);
+                guard.parked.insert(std::move(*it));
+                it = requests.erase(it);
+            }
+
+            perform();
+        }
+
+        virtual void complete(curl_base& request){
+            metrics->record(request.get_transfer_info());
+            connections->record(request.get_transfer_info());
+        }
+
     private:
-        std::unique_ptr<CURLM, detail::CURLM_deleter> handle;
+        std::shared_ptr<CURLM> handle;
+        std::unique_ptr<async_metrics> metrics{std::make_unique<async_metrics>()};
+        std::unique_ptr<connection_stats> connections{std::make_unique<connection_stats>()};
+        std::unique_ptr<std::vector<curl_base*>> suspended{std::make_unique<std::vector<curl_base*>>()};
+        std::size_t pending{};
+        std::vector<curl_base*> joining;
+        bool performing{};
+
+        void join(curl_base& request){
+            if(performing){
+                joining.push_back(std::addressof(request));
+                ++pending;
+            }
+        }
+
+        void drive(int& still_running){
+            do{
+                auto list = std::move(joining);
+                joining.clear();
+
+                for(auto* request : list)
+                    init(*request);
+
+                multi_error_checker(curl_multi_perform, &still_running);
+                process_events();
+            } while(joining.size());
+
+            update_gauges(still_running);
+        }
+
+        void set_default_option(CURLoption option, long value){
+            auto& options = prototype.default_options;
+
+            options.erase(std::remove_if(options.begin(), options.end(), [option](const auto& opt){
+                return opt->option == option;
+            }), options.end());
+
+            options.push_back(make_easy_option(option, std::move(value)));
+        }
+
+        void update_gauges(int still_running){
+            metrics->in_flight.set(still_running);
+            metrics->queued.set(std::max<std::int64_t>((std::int64_t)pending - still_running, 0));
+        }
 
         template<typename Function, typename... Args>
         void multi_error_checker(Function&& callback, Args&&... arguments){
@@ -208,6 +325,7 @@ namespace curlhttp{
 
             if(code != CURLM_OK){
                 std::error_code ec{make_multi_error_code(code)};
+                metrics->record_error(code);
 
                 if(multi_error_callback)
                     multi_error_callback(ec);
@@ -218,8 +336,81 @@ namespace curlhttp{
         }
 
         void remove(CURL* request){
-            if(curl_multi_remove_handle(handle.get(), request) == CURLM_OK)
-                requests.erase(request);
+            joining.erase(std::remove_if(joining.begin(), joining.end(), [request](curl_base* p){
+                return p->native() == request;
+            }), joining.end());
+
+            if(curl_multi_remove_handle(handle.get(), request) == CURLM_OK){
+                auto it = requests.find(request);
+
+                if(it != requests.end()){
+                    unsuspend(*it->second.request);
+                    it->second.request->suspended = nullptr;
+                    it->second.request->waker->attach({});
+                    requests.erase(it);
+                }
+            }
+        }
+
+        void unsuspend(curl_base& request){
+            if(request.paused){
+                request.paused = false;
+                suspended->erase(std::remove(suspended->begin(), suspended->end(), &request), suspended->end());
+            }
+        }
+
+        void wait(){
+#if LIBCURL_VERSION_NUM >= 0x074400
+            multi_error_checker(curl_multi_poll, nullptr, 0u, 1000, nullptr);
+#else
+            struct timeval timeout = {1, 0};
+
+            fd_set fdread;
+            fd_set fdwrite;
+            fd_set fdexcep;
+
+            long ms = -1;
+            int maxfd = -1;
+
+            FD_ZERO(&fdread);
+            FD_ZERO(&fdwrite);
+            FD_ZERO(&fdexcep);
+
+            multi_error_checker(curl_multi_timeout, &ms);
+
+            if(ms >= 0 && ms < 1000)
+                timeout = {0, (long)ms * 1000};
+
+            if(suspended->size() && (timeout.tv_sec || timeout.tv_usec > 1000))
+                timeout = {0, 1000};
+
+            multi_error_checker(curl_multi_fdset, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+            if(maxfd < 0){
+                if(timeout.tv_sec || timeout.tv_usec > 100 * 1000)
+                    timeout = {0, 100 * 1000};
+
+                select(0, 0, 0, 0, &timeout);
+            }
+
+            else
+                select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &timeout);
+#endif
+        }
+
+        void resume_suspended(){
+            if(suspended->empty())
+                return;
+
+            auto list = std::move(*suspended);
+            suspended->clear();
+
+            for(auto* request : list){
+                if(request->ready())
+                    request->resume();
+                else
+                    suspended->push_back(request);
+            }
         }
 
         void handle_removal(CURL* key, bool failed){
@@ -239,7 +430,20 @@ namespace curlhttp{
         void process_event(CURL* key, CURLcode result){
             auto& settings = requests[key];
 
-            if(settings.request->callback_exception){
+            unsuspend(*settings.request);
+
+            if(pending)
+                --pending;
+
+            settings.request->last_error = make_error_code(result);
+            settings.request->collect();
+            result = (CURLcode)settings.request->last_error.value();
+            complete(*settings.request);
+
+            if(result != CURLE_OK)
+                metrics->record_error(result);
+
+            if(settings.request->callback_exception && settings.request->throw_callback_exceptions){
                 handle_removal(key, true);
                 std::rethrow_exception(settings.request->callback_exception);
             }
@@ -255,7 +459,7 @@ namespace curlhttp{
             if(done_callback)
                 done_callback(*settings.request);
 
-            handle_removal(key, false);
+            handle_removal(key, result != CURLE_OK || (bool)settings.request->callback_exception);
         }
 
         void process_events(){
@@ -0,0 +1,183 @@
+#ifndef CURLHTTP_ASYNC_METRICS_HPP
+#define CURLHTTP_ASYNC_METRICS_HPP
+
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <curl/curl.h>
+
+#include "transfer_info_t.hpp"
+
+
+namespace curlhttp{
+
+    class sharded_counter{
+    public:
+        static constexpr std::size_t shard_count = 8;
+
+        void add(std::uint64_t n = 1){
+            shards[shard_index()].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        std::uint64_t value() const{
+            std::uint64_t result{};
+
+            for(const auto& shard : shards)
+                result += shard.value.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+    private:
+        struct alignas(64) shard_t{
+            std::atomic<std::uint64_t> value{};
+        };
+
+        std::array<shard_t, shard_count> shards{};
+
+        static std::size_t shard_index(){
+            thread_local std::size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % shard_count;
+            return index;
+        }
+    };
+
+
+    struct alignas(64) padded_gauge{
+        std::atomic<std::int64_t> value{};
+
+        void set(std::int64_t v){
+            value.store(v, std::memory_order_relaxed);
+        }
+
+        std::int64_t get() const{
+            return value.load(std::memory_order_relaxed);
+        }
+    };
+
+
+    class async_metrics{
+    public:
+        padded_gauge in_flight, queued;
+        sharded_counter loop_iterations, transfers, connected_transfers, connections, bytes_received, bytes_sent;
+        std::array<sharded_counter, 6> completions;
+        std::array<std::atomic<std::uint64_t>, CURL_LAST> easy_errors{};
+        std::array<std::atomic<std::uint64_t>, CURLM_LAST> multi_errors{};
+
+        void record(const transfer_info_t& info){
+            auto status_class = (std::size_t)(info.response_code / 100);
+
+            completions[status_class < completions.size() ? status_class : 0].add();
+            transfers.add();
+
+            if(info.connected())
+                connected_transfers.add();
+
+            connections.add((std::uint64_t)info.num_connects);
+            bytes_received.add((std::uint64_t)info.bytes_downloaded);
+            bytes_sent.add((std::uint64_t)info.bytes_uploaded);
+        }
+
+        void record_error(CURLcode code){
+            if(code > CURLE_OK && code < CURL_LAST)
+                easy_errors[code].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void record_error(CURLMcode code){
+            if(code > CURLM_OK && code < CURLM_LAST)
+                multi_errors[code].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        double connection_reuse_ratio() const{
+            auto t = connected_transfers.value();
+            auto c = connections.value();
+
+            return t && c < t ? 1.0 - (double)c / (double)t : 0.0;
+        }
+
+        std::string prometheus(const std::string& prefix = "curlhttp") const{
+            std::string s;
+
+            metric(s, prefix + "_in_flight", "gauge", "Transfers currently running");
+            sample(s, prefix + "_in_flight", "", std::to_string(in_flight.get()));
+
+            metric(s, prefix + "_queued", "gauge", "Requests added but not running");
+            sample(s, prefix + "_queued", "", std::to_string(queued.get()));
+
+            metric(s, prefix + "_loop_iterations_total", "counter", "Event loop iterations");
+            sample(s, prefix + "_loop_iterations_total", "", std::to_string(loop_iterations.value()));
+
+            metric(s, prefix + "_completions_total", "counter", "Completed transfers by status class");
+
+            for(std::size_t n{}; n < completions.size(); ++n)
+                sample(s, prefix + "_completions_total", n ? "class=\"" + std::to_string(n) + "xx\"" : "class=\"none\"",
+                       std::to_string(completions[n].value()));
+
+            metric(s, prefix + "_easy_errors_total", "counter", "Transfer errors by CURLcode");
+
+            for(std::size_t n{}; n < easy_errors.size(); ++n){
+                if(auto v = easy_errors[n].load(std::memory_order_relaxed))
+                    sample(s, prefix + "_easy_errors_total", error_labels((int)n, curl_easy_strerror((CURLcode)n)), std::to_string(v));
+            }
+
+            metric(s, prefix + "_multi_errors_total", "counter", "Multi interface errors by CURLMcode");
+
+            for(std::size_t n{}; n < multi_errors.size(); ++n){
+                if(auto v = multi_errors[n].load(std::memory_order_relaxed))
+                    sample(s, prefix + "_multi_errors_total", error_labels((int)n, curl_multi_strerror((CURLMcode)n)), std::to_string(v));
+            }
+
+            metric(s, prefix + "_bytes_received_total", "counter", "Body bytes received");
+            sample(s, prefix + "_bytes_received_total", "", std::to_string(bytes_received.value()));
+
+            metric(s, prefix + "_bytes_sent_total", "counter", "Body bytes sent");
+            sample(s, prefix + "_bytes_sent_total", "", std::to_string(bytes_sent.value()));
+
+            metric(s, prefix + "_transfers_total", "counter", "Finished transfers");
+            sample(s, prefix + "_transfers_total", "", std::to_string(transfers.value()));
+
+            metric(s, prefix + "_connections_total", "counter", "New connections opened by finished transfers");
+            sample(s, prefix + "_connections_total", "", std::to_string(connections.value()));
+
+            metric(s, prefix + "_connection_reuse_ratio", "gauge", "Share of connected transfers that reused a connection");
+            sample(s, prefix + "_connection_reuse_ratio", "", std::to_string(connection_reuse_ratio()));
+
+            return s;
+        }
+
+    private:
+        static void metric(std::string& s, const std::string& name, const char* type, const char* help){
+            s += "# HELP " + name + ' ' + help + "\n# TYPE " + name + ' ' + type + '\n';
+        }
+
+        static void sample(std::string& s, const std::string& name, const std::string& labels, const std::string& value){
+            s += name;
+
+            if(labels.size())
+                s += '{' + labels + '}';
+
+            s += ' ' + value + '\n';
+        }
+
+        static std::string error_labels(int code, const char* message){
+            std::string s = "code=\"" + std::to_string(code) + "\",error=\"";
+
+            for(const char* p = message; *p; ++p){
+                if(*p == '"' || *p == '\\')
+                    s += '\\';
+
+                s += *p == '\n' ? ' ' : *p;
+            }
+
+            return s += '"';
+        }
+    };
+
+}
+
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef CURLHTTP_CALLBACK_HOOKS_HPP
+#define CURLHTTP_CALLBACK_HOOKS_HPP
+
+
+#include <string_view>
+
+#include "header_block_t.hpp"
+#include "status_code.hpp"
+
+
+namespace curlhttp{
+
+    struct function_hooks {};
+
+
+    struct static_hooks{
+        static bool rx(std::string_view ){
+            return true;
+        }
+
+        static bool tx(std::string_view ){
+            return true;
+        }
+
+        static bool status(status_code ){
+            return true;
+        }
+
+        static bool response(const header_view_t& ){
+            return true;
+        }
+    };
+
+}
+
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef CURLHTTP_COMPRESSED_T_HPP
+#define CURLHTTP_COMPRESSED_T_HPP
+
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <zlib.h>
+
+#ifdef CURLHTTP_USE_ZSTD
+    #include <zstd.h>
+#endif
+
+#include <curl/curl.h>
+
+#include "curl_error.hpp"
+#include "default_reader.hpp"
+#include "default_seeker.hpp"
+#include "size_getter.hpp"
+
+
+namespace curlhttp{
+
+    enum class compression_t : char{
+        gzip, deflate, zstd
+    };
+
+
+    template<typename TX, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>>
+    class compressed_t{
+    public:
+        static constexpr std::size_t input_size = 64 * 1024;
+        static constexpr int default_level = -1;
+
+        TX& source;
+        compression_t method;
+        int level;
+
+        compressed_t(TX& src, compression_t m = compression_t::gzip, int lvl = default_level)
+            : source{src}, method{m}, level{lvl}, input(input_size){
+#ifndef CURLHTTP_USE_ZSTD
+            if(method == compression_t::zstd)
+                throw curl_error{make_error_code(CURLE_NOT_BUILT_IN), "zstd support requires CURLHTTP_USE_ZSTD"};
+#endif
+        }
+
+        compressed_t(const compressed_t& ) = delete;
+        compressed_t& operator= (const compressed_t& ) = delete;
+
+        ~compressed_t(){
+            if(zlib)
+                deflateEnd(zlib.get());
+        }
+
+        const char* content_encoding() const{
+            switch(method){
+                case compression_t::gzip: return "gzip";
+                case compression_t::deflate: return "deflate";
+                case compression_t::zstd: return "zstd";
+            }
+
+            return "identity";
+        }
+
+        std::uint64_t bytes_in() const{
+            return consumed;
+        }
+
+        std::uint64_t bytes_out() const{
+            return produced;
+        }
+
+        double ratio() const{
+            return consumed ? (double)produced / (double)consumed : 0.0;
+        }
+
+        void restart(){
+            pending = {};
+            source_eof = false;
+            finished = false;
+            consumed = 0;
+            produced = 0;
+
+            if(zlib)
+                deflateReset(zlib.get());
+
+#ifdef CURLHTTP_USE_ZSTD
+            if(zstd)
+                ZSTD_CCtx_reset(zstd.get(), ZSTD_reset_session_only);
+#endif
+        }
+
+        std::size_t read(char* buffer, std::size_t size){
+            std::size_t result{};
+
+            while(!result && !finished){
+                if(pending.first == pending.second && !source_eof)
+                    fill();
+
+#ifdef CURLHTTP_USE_ZSTD
+                result = method == compression_t::zstd ? compress_zstd(buffer, size) : compress_zlib(buffer, size);
+#else
+                result = compress_zlib(buffer, size);
+#endif
+            }
+
+            produced += result;
+            return result;
+        }
+
+        int seek(curl_off_t offset, int origin){
+            if(offset || origin != SEEK_SET || Seeker{}(source, 0, SEEK_SET) != CURL_SEEKFUNC_OK)
+                return CURL_SEEKFUNC_CANTSEEK;
+
+            restart();
+            return CURL_SEEKFUNC_OK;
+        }
+
+    private:
+        struct z_stream_deleter{
+            void operator()(z_stream* p){
+                delete p;
+            }
+        };
+
+#ifdef CURLHTTP_USE_ZSTD
+        struct zstd_deleter{
+            void operator()(ZSTD_CCtx* p){
+                ZSTD_freeCCtx(p);
+            }
+        };
+
+        std::unique_ptr<ZSTD_CCtx, zstd_deleter> zstd;
+#endif
+
+        std::unique_ptr<z_stream, z_stream_deleter> zlib;
+        std::vector<char> input;
+        std::pair<std::size_t, std::size_t> pending{};
+        std::uint64_t consumed{}, produced{};
+        bool source_eof{}, finished{};
+
+        void fill(){
+            std::size_t n = Reader{}(source, input.data(), 1, input.size());
+
+            if(n == CURL_READFUNC_ABORT || n == CURL_READFUNC_PAUSE || n > input.size())
+                throw curl_error{make_error_code(CURLE_READ_ERROR), "Cannot read upload source"};
+
+            pending = {0, n};
+            consumed += n;
+            source_eof = !n;
+        }
+
+        std::size_t compress_zlib(char* buffer, std::size_t size){
+            if(!zlib){
+                zlib.reset(new z_stream{});
+                int bits = method == compression_t::gzip ? 15 + 16 : 15;
+
+                if(deflateInit2(zlib.get(), level, Z_DEFLATED, bits, 8, Z_DEFAULT_STRATEGY) != Z_OK){
+                    zlib.reset();
+                    throw curl_error{make_error_code(CURLE_OUT_OF_MEMORY), "Cannot initialize deflate"};
+                }
+            }
+
+            zlib->next_in = (Bytef*)input.data() + pending.first;
+            zlib->avail_in = (uInt)(pending.second - pending.first);
+            zlib->next_out = (Bytef*)buffer;
+            zlib->avail_out = (uInt)size;
+
+            int rc = deflate(zlib.get(), source_eof ? Z_FINISH : Z_NO_FLUSH);
+
+            if(rc == Z_STREAM_ERROR)
+                throw curl_error{make_error_code(CURLE_SEND_ERROR), "Cannot compress upload"};
+
+            pending.first = pending.second - zlib->avail_in;
+            finished = rc == Z_STREAM_END;
+
+            return size - zlib->avail_out;
+        }
+
+#ifdef CURLHTTP_USE_ZSTD
+        std::size_t compress_zstd(char* buffer, std::size_t size){
+            if(!zstd){
+                zstd.reset(ZSTD_createCCtx());
+
+                if(!zstd)
+                    throw curl_error{make_error_code(CURLE_OUT_OF_MEMORY), "Cannot initialize zstd"};
+
+                ZSTD_CCtx_setParameter(zstd.get(), ZSTD_c_compressionLevel, level == default_level ? ZSTD_CLEVEL_DEFAULT : level);
+            }
+
+            ZSTD_inBuffer in{input.data(), pending.second, pending.first};
+            ZSTD_outBuffer out{buffer, size, 0};
+
+            std::size_t rc = ZSTD_compressStream2(zstd.get(), &out, &in, source_eof ? ZSTD_e_end : ZSTD_e_continue);
+
+            if(ZSTD_isError(rc))
+                throw curl_error{make_error_code(CURLE_SEND_ERROR), ZSTD_getErrorName(rc)};
+
+            pending.first = in.pos;
+            finished = source_eof && !rc;
+
+            return out.pos;
+        }
+#endif
+    };
+
+
+    template<typename TX, typename Reader, typename Seeker>
+    struct default_reader<compressed_t<TX, Reader, Seeker>>{
+        std::size_t operator()(compressed_t<TX, Reader, Seeker>& stream, char* buffer, std::size_t size, std::size_t nmemb){
+            return stream.read(buffer, size * nmemb);
+        }
+    };
+
+
+    template<typename TX, typename Reader, typename Seeker>
+    struct default_seeker<compressed_t<TX, Reader, Seeker>>{
+        int operator()(compressed_t<TX, Reader, Seeker>& stream, curl_off_t offset, int origin){
+            return stream.seek(offset, origin);
+        }
+    };
+
+
+    template<typename TX, typename Reader, typename Seeker>
+    struct size_getter<compressed_t<TX, Reader, Seeker>>{
+        std::size_t operator()(const compressed_t<TX, Reader, Seeker>& ) const{
+            return unknown_size;
+        }
+    };
+
+}
+
+
+#endif
@@ -4,18 +4,24 @@
 
 #include <memory>
 #include <functional>
+#include <vector>
 #include <curl/curl.h>
 
 #include "detail.hpp"
+#include "debug_ring.hpp"
+#include "notifier_t.hpp"
 #include "url_t.hpp"
 #include "curl_error.hpp"
 #include "option_t.hpp"
+#include "result_t.hpp"
+#include "transfer_info_t.hpp"
 #include<iostream>
 
 namespace curlhttp{
 
     class curl_base{
         friend class async_handle;
+        friend class basic_mime_data;
 
     public:
         static constexpr std::size_t default_write_abort = CURL_MAX_WRITE_SIZE + 1;
@@ -27,10 +33,16 @@ namespace curlhttp{
         url_t url;
         callback_t done_callback, timeout_callback;
         error_callback_t easy_error_callback;
+        std::shared_ptr<debug_ring> debug;
         bool throw_easy_errors{true};
+        bool throw_callback_exceptions{true};
 
         virtual void init(){
             callback_exception = {};
+            last_error = {};
+
+            if(debug || debug_enabled)
+                setup_debug();
 
             setup_upload();
             setup_header_download();
@@ -48,8 +60,11 @@ namespace curlhttp{
             done_callback = {};
             timeout_callback = {};
             easy_error_callback = {};
+            debug.reset();
+            debug_enabled = false;
 
             throw_easy_errors = true;
+            throw_callback_exceptions = true;
             last_error = std::error_code{};
         }
 
@@ -57,8 +72,9 @@ namespace curlhttp{
             init();
 
             last_error = make_error_code(curl_easy_perform(handle.get()));
+            collect();
 
-            if(callback_exception)
+            if(callback_exception && throw_callback_exceptions)
                 std::rethrow_exception(callback_exception);
 
             if(last_error.value() != CURLE_OK)
@@ -83,6 +99,18 @@ namespace curlhttp{
             return last_error;
         }
 
+        const std::exception_ptr& get_callback_exception() const{
+            return callback_exception;
+        }
+
+        virtual result_t result() const{
+            return {last_error, {}};
+        }
+
+        const transfer_info_t& get_transfer_info() const{
+            return transfer_info;
+        }
+
         template<typename T>
         void set_option(CURLoption option, const T& value){
             easy_error_checker(::curl_easy_setopt, option, value);
@@ -104,9 +132,14 @@ namespace curlhttp{
             return handle.get();
         }
 
+        bool is_paused() const{
+            return paused;
+        }
+
     protected:
         std::exception_ptr callback_exception;
         std::unique_ptr<CURL, detail::CURL_deleter> handle;
+        std::shared_ptr<detail::waker_t> waker{std::make_shared<detail::waker_t>()};
 
         curl_base(const url_t& uri)
             : url{uri}, handle{curl_easy_init()} {}
@@ -116,7 +149,14 @@ namespace curlhttp{
 
         virtual ~curl_base() {}
 
+        virtual void collect(){
+            transfer_info.collect(handle.get());
+        }
+
         void handle_easy_error(const std::error_code& ec){
+            if(debug)
+                debug->failed(handle.get());
+
             if(easy_error_callback)
                 easy_error_callback(ec);
 
@@ -127,10 +167,11 @@ namespace curlhttp{
         template<typename Function, typename... Args>
         void easy_error_checker(Function&& callback, Args&&... arguments){
             CURLcode code = std::forward<Function>(callback)(handle.get(), std::forward<Args>(arguments)...);
-            last_error = make_error_code(code);
 
-            if(code != CURLE_OK)
-                handle_easy_error(make_error_code(code));
+            if(code != CURLE_OK){
+                last_error = make_error_code(code);
+                handle_easy_error(last_error);
+            }
         }
 
         virtual void setup_upload() = 0;
@@ -138,8 +179,55 @@ namespace curlhttp{
         virtual void setup_download() = 0;
         virtual void setup_seeking() = 0;
 
+        virtual bool ready() const{
+            return true;
+        }
+
+        void set_last_error(const std::error_code& ec){
+            last_error = ec;
+        }
+
+        bool suspend(){
+            if(suspended){
+                paused = true;
+                suspended->push_back(this);
+                return true;
+            }
+
+            waker->wait([this]{
+                return ready();
+            });
+
+            return false;
+        }
+
     private:
         std::error_code last_error;
+        transfer_info_t transfer_info;
+        std::vector<curl_base*>* suspended{};
+
+        bool debug_enabled{};
+        bool paused{};
+
+        void resume(){
+            paused = false;
+            curl_easy_pause(handle.get(), CURLPAUSE_CONT);
+        }
+
+        void setup_debug(){
+            debug_enabled = (bool)debug;
+
+            set_option(CURLOPT_DEBUGDATA, this);
+            set_option(CURLOPT_DEBUGFUNCTION, &curl_base::debug_callback);
+            set_option(CURLOPT_VERBOSE, debug_enabled ? 1L : 0L);
+        }
+
+        static int debug_callback(CURL* handle, curl_infotype type, char* data, std::size_t size, curl_base* this_){
+            if(this_->debug)
+                this_->debug->push(handle, type, data, size);
+
+            return 0;
+        }
     };
 
 
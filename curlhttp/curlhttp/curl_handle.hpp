@@ -3,18 +3,21 @@
 
 
 #include <string_view>
+#include <type_traits>
 
 #include "curl_base.hpp"
+#include "callback_hooks.hpp"
 #include "default_writer.hpp"
 #include "default_reader.hpp"
 #include "default_seeker.hpp"
-#include "response_t.hpp"
+#include "header_block_t.hpp"
 
 
 namespace curlhttp{
 
     template<typename RX, typename TX,
-             typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>>
+             typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>,
+             typename Hooks = function_hooks>
     class curl_handle : public curl_base{
     public:
         using rx_buffer_t = RX;
@@ -23,6 +26,7 @@ namespace curlhttp{
         using writer_t = Writer;
         using reader_t = Reader;
         using seeker_t = Seeker;
+        using hooks_t = Hooks;
 
         using rx_callback_t = std::function<bool(const std::string_view& )>;
         using tx_callback_t = std::function<bool(const std::string_view& )>;
@@ -41,6 +45,11 @@ namespace curlhttp{
 
         virtual ~curl_handle() {}
 
+        void init() override{
+            response_headers.clear();
+            curl_base::init();
+        }
+
         void reset() override{
             curl_base::reset();
 
@@ -50,10 +59,18 @@ namespace curlhttp{
             response_headers.clear();
         }
 
-        const std::vector<std::string> get_response_headers() const{
+        const header_block_t& get_response_headers() const{
             return response_headers;
         }
 
+        writer_t& get_writer(){
+            return writer;
+        }
+
+        const writer_t& get_writer() const{
+            return writer;
+        }
+
         void* rx_buffer_ptr() const override{
             return std::addressof(rx_buffer);
         }
@@ -62,11 +79,40 @@ namespace curlhttp{
         }
 
     protected:
-        std::vector<std::string> response_headers;
-        std::string response_buffer;
-        default_writer<std::string> string_writer;
+        header_block_t response_headers;
+
+        bool on_rx(std::string_view data){
+            if constexpr(std::is_same_v<hooks_t, function_hooks>)
+                return !rx_callback || rx_callback(data);
+            else
+                return hooks_t::rx(data);
+        }
+
+        bool on_tx(std::string_view data){
+            if constexpr(std::is_same_v<hooks_t, function_hooks>)
+                return !tx_callback || tx_callback(data);
+            else
+                return hooks_t::tx(data);
+        }
+
+        void collect() override{
+            curl_base::collect();
+
+            if constexpr(detail::has_close<RX>::value)
+                rx_buffer.close();
+        }
 
         void setup_download() override{
+            write_paused = false;
+
+            if constexpr(detail::has_restart<RX>::value)
+                rx_buffer.restart();
+
+            if constexpr(detail::has_notifier<RX>::value)
+                rx_buffer.set_notifier([w = waker]{
+                    w->notify();
+                });
+
             set_option(CURLOPT_WRITEDATA, this);
             set_option(CURLOPT_WRITEFUNCTION, &curl_handle::write_callback);
         }
@@ -77,6 +123,11 @@ namespace curlhttp{
         }
 
         void setup_upload() override{
+            if constexpr(detail::has_notifier<TX>::value)
+                tx_buffer.set_notifier([w = waker]{
+                    w->notify();
+                });
+
             set_option(CURLOPT_READDATA, this);
             set_option(CURLOPT_READFUNCTION, &curl_handle::read_callback);
         }
@@ -86,16 +137,41 @@ namespace curlhttp{
             set_option(CURLOPT_SEEKFUNCTION, &curl_handle::seek_callback);
         }
 
+        bool ready() const override{
+            if(write_paused){
+                if constexpr(detail::has_writable<RX>::value)
+                    return rx_buffer.writable();
+                else
+                    return true;
+            }
+
+            if constexpr(detail::has_readable<TX>::value)
+                return tx_buffer.readable();
+            else
+                return true;
+        }
+
     private:
         writer_t writer;
         reader_t reader;
         seeker_t seeker;
+        bool write_paused{};
 
         static std::size_t write_callback(char* buffer, std::size_t sz, std::size_t nmemb, curl_handle* this_) try{
-            if(this_->rx_callback && !this_->rx_callback(std::string_view{buffer, sz * nmemb}))
+            std::size_t size;
+
+            if(!this_->write_paused && !this_->on_rx(std::string_view{buffer, sz * nmemb}))
                 return default_write_abort;
 
-            return this_->writer(this_->rx_buffer, buffer, sz, nmemb);
+            while((size = this_->writer(this_->rx_buffer, buffer, sz, nmemb)) == CURL_WRITEFUNC_PAUSE){
+                this_->write_paused = true;
+
+                if(this_->suspend())
+                    return size;
+            }
+
+            this_->write_paused = false;
+            return size;
         }
 
         catch(...){
@@ -105,21 +181,13 @@ namespace curlhttp{
 
 
         static std::size_t write_header_callback(char* buffer, std::size_t sz, std::size_t nmemb, curl_handle* this_) try{
-            if(this_->rx_callback && !this_->rx_callback(std::string_view{buffer, sz * nmemb}))
-                return default_write_abort;
-
             std::size_t size = sz * nmemb;
 
-            if(size == 2 && !std::strncmp(buffer, "\r\n", 2)){
-                size = this_->string_writer(this_->response_buffer, buffer, sz, nmemb);
-
-                this_->response_headers.push_back(this_->response_buffer);
-                this_->response_buffer.clear();
-
-                return size;
-            }
+            if(!this_->on_rx(std::string_view{buffer, size}))
+                return default_write_abort;
 
-            return this_->string_writer(this_->response_buffer, buffer, sz, nmemb);
+            this_->response_headers.append(buffer, size);
+            return size;
         }
 
         catch(...){
@@ -129,9 +197,17 @@ namespace curlhttp{
 
 
         static std::size_t read_callback(char* buffer, std::size_t sz, std::size_t nmemb, curl_handle* this_) try{
-            std::size_t size = this_->reader(this_->tx_buffer, buffer, sz, nmemb);
+            std::size_t size;
+
+            while((size = this_->reader(this_->tx_buffer, buffer, sz, nmemb)) == CURL_READFUNC_PAUSE){
+                if(this_->suspend())
+                    return size;
+            }
+
+            if(size == CURL_READFUNC_ABORT)
+                return size;
 
-            if(this_->tx_callback && !this_->tx_callback(std::string_view{buffer, size}))
+            if(!this_->on_tx(std::string_view{buffer, size}))
                 return default_read_abort;
 
             return size;
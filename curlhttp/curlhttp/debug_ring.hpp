@@ -0,0 +1,140 @@
+#ifndef CURLHTTP_DEBUG_RING_HPP
+#define CURLHTTP_DEBUG_RING_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <curl/curl.h>
+
+
+namespace curlhttp{
+
+    class debug_ring{
+    public:
+        using clock_type = std::chrono::steady_clock;
+        using dump_callback_t = std::function<void(const std::string& )>;
+
+        struct event_t{
+            CURL* handle{};
+            curl_infotype type{};
+            clock_type::time_point time;
+            std::size_t size{};
+            std::string data;
+        };
+
+        dump_callback_t on_failure;
+
+        explicit debug_ring(std::size_t nslots = 256, std::size_t max_data = 256, bool data = false)
+            : slots(std::max<std::size_t>(nslots, 1)), data_limit{max_data}, capture_data{data}{
+            for(auto& slot : slots)
+                slot.data.reserve(data_limit);
+        }
+
+        bool wants(curl_infotype type) const{
+            return capture_data || type == CURLINFO_TEXT || type == CURLINFO_HEADER_IN || type == CURLINFO_HEADER_OUT;
+        }
+
+        void push(CURL* handle, curl_infotype type, const char* data, std::size_t size){
+            if(!wants(type))
+                return;
+
+            std::lock_guard<std::mutex> lock{mutex};
+            auto& slot = slots[next++ % slots.size()];
+
+            slot.handle = handle;
+            slot.type = type;
+            slot.time = clock_type::now();
+            slot.size = size;
+            slot.data.assign(data, std::min(size, data_limit));
+        }
+
+        std::vector<event_t> events(CURL* handle = nullptr) const{
+            std::lock_guard<std::mutex> lock{mutex};
+            std::vector<event_t> result;
+            std::size_t count = std::min<std::size_t>(next, slots.size());
+
+            for(std::size_t n = next - count; n < next; ++n){
+                const auto& slot = slots[n % slots.size()];
+
+                if(!handle || slot.handle == handle)
+                    result.push_back(slot);
+            }
+
+            return result;
+        }
+
+        std::string dump(CURL* handle = nullptr) const{
+            auto list = events(handle);
+            std::string s;
+
+            for(const auto& event : list){
+                s += prefix(event.type);
+
+                if(event.type == CURLINFO_TEXT || event.type == CURLINFO_HEADER_IN || event.type == CURLINFO_HEADER_OUT)
+                    s += event.data;
+
+                else
+                    s += printable(event.data);
+
+                if(event.data.size() < event.size)
+                    s += "... [" + std::to_string(event.size) + " bytes]";
+
+                if(s.empty() || s.back() != '\n')
+                    s += '\n';
+            }
+
+            return s;
+        }
+
+        void failed(CURL* handle) const{
+            if(on_failure)
+                on_failure(dump(handle));
+        }
+
+        void clear(){
+            std::lock_guard<std::mutex> lock{mutex};
+            next = 0;
+        }
+
+    private:
+        mutable std::mutex mutex;
+        std::vector<event_t> slots;
+        std::uint64_t next{};
+        std::size_t data_limit;
+        bool capture_data;
+
+        static const char* prefix(curl_infotype type){
+            switch(type){
+                case CURLINFO_TEXT: return "* ";
+                case CURLINFO_HEADER_IN: return "< ";
+                case CURLINFO_HEADER_OUT: return "> ";
+                case CURLINFO_DATA_IN: return "<= ";
+                case CURLINFO_DATA_OUT: return "=> ";
+                case CURLINFO_SSL_DATA_IN: return "<= ssl ";
+                case CURLINFO_SSL_DATA_OUT: return "=> ssl ";
+                default: return "? ";
+            }
+        }
+
+        static std::string printable(const std::string& data){
+            std::string s{data};
+
+            for(auto& c : s){
+                if((unsigned char)c < 0x20 || (unsigned char)c > 0x7e)
+                    c = '.';
+            }
+
+            return s;
+        }
+    };
+
+}
+
+
+#endif
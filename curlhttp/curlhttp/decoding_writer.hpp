@@ -0,0 +1,415 @@
+#ifndef CURLHTTP_DECODING_WRITER_HPP
+#define CURLHTTP_DECODING_WRITER_HPP
+
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <zlib.h>
+
+#ifdef CURLHTTP_USE_BROTLI
+    #include <brotli/decode.h>
+#endif
+
+#ifdef CURLHTTP_USE_ZSTD
+    #include <zstd.h>
+#endif
+
+#include "curl_error.hpp"
+#include "default_writer.hpp"
+#include "utility.hpp"
+
+
+namespace curlhttp{
+
+    enum class accept_encoding_t : char{
+        none, libcurl, writer
+    };
+
+
+    namespace detail{
+
+        template<typename T, typename Init, typename Reset, typename Free>
+        class decoder_pool{
+        public:
+            struct deleter{
+                void operator()(T* p){
+                    decoder_pool::release(p);
+                }
+            };
+
+            using pointer = std::unique_ptr<T, deleter>;
+
+            static pointer acquire(){
+                auto& cache = instance();
+
+                if(cache.free.size()){
+                    T* p = cache.free.back();
+                    cache.free.pop_back();
+                    return pointer{Reset{}(p)};
+                }
+
+                return pointer{Init{}()};
+            }
+
+        private:
+            std::vector<T*> free;
+
+            ~decoder_pool(){
+                for(T* p : free)
+                    Free{}(p);
+            }
+
+            static decoder_pool& instance(){
+                thread_local decoder_pool pool;
+                return pool;
+            }
+
+            static void release(T* p){
+                auto& cache = instance();
+
+                if(cache.free.size() < 16)
+                    cache.free.push_back(p);
+                else
+                    Free{}(p);
+            }
+        };
+
+
+        struct zlib_init{
+            z_stream* operator()() const{
+                auto p = new z_stream{};
+
+                if(inflateInit2(p, 15 + 32) != Z_OK){
+                    delete p;
+                    throw curl_error{make_error_code(CURLE_OUT_OF_MEMORY), "Cannot initialize inflate"};
+                }
+
+                return p;
+            }
+        };
+
+        struct zlib_reset{
+            z_stream* operator()(z_stream* p) const{
+                inflateReset2(p, 15 + 32);
+                return p;
+            }
+        };
+
+        struct zlib_free{
+            void operator()(z_stream* p) const{
+                inflateEnd(p);
+                delete p;
+            }
+        };
+
+        using zlib_pool = decoder_pool<z_stream, zlib_init, zlib_reset, zlib_free>;
+
+
+#ifdef CURLHTTP_USE_ZSTD
+        struct zstd_init{
+            ZSTD_DCtx* operator()() const{
+                if(auto p = ZSTD_createDCtx())
+                    return p;
+
+                throw curl_error{make_error_code(CURLE_OUT_OF_MEMORY), "Cannot initialize zstd"};
+            }
+        };
+
+        struct zstd_reset{
+            ZSTD_DCtx* operator()(ZSTD_DCtx* p) const{
+                ZSTD_DCtx_reset(p, ZSTD_reset_session_only);
+                return p;
+            }
+        };
+
+        struct zstd_free{
+            void operator()(ZSTD_DCtx* p) const{
+                ZSTD_freeDCtx(p);
+            }
+        };
+
+        using zstd_pool = decoder_pool<ZSTD_DCtx, zstd_init, zstd_reset, zstd_free>;
+#endif
+
+
+#ifdef CURLHTTP_USE_BROTLI
+        struct brotli_init{
+            BrotliDecoderState* operator()() const{
+                if(auto p = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr))
+                    return p;
+
+                throw curl_error{make_error_code(CURLE_OUT_OF_MEMORY), "Cannot initialize brotli"};
+            }
+        };
+
+        // The brotli decoder has no reset call, so a recycled slot gets a fresh instance.
+        struct brotli_reset{
+            BrotliDecoderState* operator()(BrotliDecoderState* p) const{
+                BrotliDecoderDestroyInstance(p);
+                return brotli_init{}();
+            }
+        };
+
+        struct brotli_free{
+            void operator()(BrotliDecoderState* p) const{
+                BrotliDecoderDestroyInstance(p);
+            }
+        };
+
+        using brotli_pool = decoder_pool<BrotliDecoderState, brotli_init, brotli_reset, brotli_free>;
+#endif
+
+    }
+
+
+    inline const char* supported_encodings(){
+#if defined(CURLHTTP_USE_BROTLI) && defined(CURLHTTP_USE_ZSTD)
+        return "gzip, deflate, br, zstd";
+#elif defined(CURLHTTP_USE_BROTLI)
+        return "gzip, deflate, br";
+#elif defined(CURLHTTP_USE_ZSTD)
+        return "gzip, deflate, zstd";
+#else
+        return "gzip, deflate";
+#endif
+    }
+
+
+    template<typename RX, typename Writer = default_writer<RX>>
+    class decoding_writer{
+    public:
+        static constexpr std::size_t output_size = 64 * 1024;
+
+        std::size_t operator()(RX& rx, const char* buffer, std::size_t size, std::size_t nmemb){
+            std::size_t length = size * nmemb;
+            wire += length;
+
+            switch(codec){
+                case codec_t::identity:
+                    decoded += length;
+                    return writer(rx, buffer, size, nmemb);
+
+                case codec_t::zlib:
+                    return decode_zlib(rx, buffer, length) ? length : 0;
+
+#ifdef CURLHTTP_USE_BROTLI
+                case codec_t::brotli:
+                    return decode_brotli(rx, buffer, length) ? length : 0;
+#endif
+
+#ifdef CURLHTTP_USE_ZSTD
+                case codec_t::zstd:
+                    return decode_zstd(rx, buffer, length) ? length : 0;
+#endif
+
+                default:
+                    return 0;
+            }
+        }
+
+        void content_encoding(std::string_view encoding){
+            release();
+
+            while(encoding.size() && (encoding.back() == ' ' || encoding.back() == '\t'))
+                encoding.remove_suffix(1);
+
+            if(encoding.empty() || ascii_icase_compare(encoding, "identity"))
+                codec = codec_t::identity;
+
+            else if(ascii_icase_compare(encoding, "gzip") || ascii_icase_compare(encoding, "x-gzip") || ascii_icase_compare(encoding, "deflate")){
+                zlib = detail::zlib_pool::acquire();
+                detecting = ascii_icase_compare(encoding, "deflate");
+                members = !detecting;
+                codec = codec_t::zlib;
+            }
+
+#ifdef CURLHTTP_USE_BROTLI
+            else if(ascii_icase_compare(encoding, "br")){
+                brotli = detail::brotli_pool::acquire();
+                codec = codec_t::brotli;
+            }
+#endif
+
+#ifdef CURLHTTP_USE_ZSTD
+            else if(ascii_icase_compare(encoding, "zstd")){
+                zstd = detail::zstd_pool::acquire();
+                codec = codec_t::zstd;
+            }
+#endif
+
+            else
+                codec = codec_t::unsupported;
+        }
+
+        void restart(){
+            release();
+            codec = codec_t::identity;
+            wire = 0;
+            decoded = 0;
+        }
+
+        std::uint64_t wire_bytes() const{
+            return wire;
+        }
+
+        std::uint64_t decoded_bytes() const{
+            return decoded;
+        }
+
+        bool complete() const{
+            return !wire || codec == codec_t::identity || ended;
+        }
+
+    private:
+        enum class codec_t : char{
+            identity, zlib, brotli, zstd, unsupported
+        };
+
+        Writer writer;
+        codec_t codec{};
+        std::uint64_t wire{}, decoded{};
+        std::vector<char> output;
+        detail::zlib_pool::pointer zlib;
+        std::string head;
+        bool detecting{}, members{}, ended{};
+
+#ifdef CURLHTTP_USE_BROTLI
+        detail::brotli_pool::pointer brotli;
+#endif
+
+#ifdef CURLHTTP_USE_ZSTD
+        detail::zstd_pool::pointer zstd;
+#endif
+
+        void release(){
+            zlib.reset();
+            head.clear();
+            detecting = false;
+            members = false;
+            ended = false;
+
+#ifdef CURLHTTP_USE_BROTLI
+            brotli.reset();
+#endif
+
+#ifdef CURLHTTP_USE_ZSTD
+            zstd.reset();
+#endif
+        }
+
+        bool deliver(RX& rx, std::size_t n){
+            decoded += n;
+            return !n || writer(rx, output.data(), 1, n) == n;
+        }
+
+        bool decode_zlib(RX& rx, const char* buffer, std::size_t length){
+            if(!detecting)
+                return inflate_zlib(rx, buffer, length);
+
+            head.append(buffer, length);
+
+            if(head.size() < 2)
+                return true;
+
+            auto cmf = (unsigned char)head[0], flg = (unsigned char)head[1];
+
+            if((cmf & 0x0f) != 8 || (cmf >> 4) > 7 || (cmf << 8 | flg) % 31)
+                inflateReset2(zlib.get(), -15);
+
+            detecting = false;
+
+            bool ok = inflate_zlib(rx, head.data(), head.size());
+            head.clear();
+            return ok;
+        }
+
+        bool inflate_zlib(RX& rx, const char* buffer, std::size_t length){
+            output.resize(output_size);
+
+            zlib->next_in = (Bytef*)buffer;
+            zlib->avail_in = (uInt)length;
+
+            for(;;){
+                if(ended && zlib->avail_in){
+                    if(!members)
+                        return false;
+
+                    inflateReset(zlib.get());
+                    ended = false;
+                }
+
+                zlib->next_out = (Bytef*)output.data();
+                zlib->avail_out = (uInt)output.size();
+
+                int rc = inflate(zlib.get(), Z_NO_FLUSH);
+
+                if(rc != Z_OK && rc != Z_STREAM_END && rc != Z_BUF_ERROR)
+                    return false;
+
+                if(!deliver(rx, output.size() - zlib->avail_out))
+                    return false;
+
+                ended = rc == Z_STREAM_END;
+
+                if(!zlib->avail_in && (ended || zlib->avail_out))
+                    return true;
+            }
+        }
+
+#ifdef CURLHTTP_USE_BROTLI
+        bool decode_brotli(RX& rx, const char* buffer, std::size_t length){
+            output.resize(output_size);
+
+            const std::uint8_t* next_in = (const std::uint8_t*)buffer;
+            std::size_t avail_in = length;
+
+            for(;;){
+                std::uint8_t* next_out = (std::uint8_t*)output.data();
+                std::size_t avail_out = output.size();
+
+                auto rc = BrotliDecoderDecompressStream(brotli.get(), &avail_in, &next_in, &avail_out, &next_out, nullptr);
+
+                if(rc == BROTLI_DECODER_RESULT_ERROR || !deliver(rx, output.size() - avail_out))
+                    return false;
+
+                ended = rc == BROTLI_DECODER_RESULT_SUCCESS;
+
+                if(ended && avail_in)
+                    return false;
+
+                if(rc != BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT)
+                    return true;
+            }
+        }
+#endif
+
+#ifdef CURLHTTP_USE_ZSTD
+        bool decode_zstd(RX& rx, const char* buffer, std::size_t length){
+            output.resize(output_size);
+
+            ZSTD_inBuffer in{buffer, length, 0};
+
+            for(;;){
+                ZSTD_outBuffer out{output.data(), output.size(), 0};
+                std::size_t rc = ZSTD_decompressStream(zstd.get(), &out, &in);
+
+                if(ZSTD_isError(rc) || !deliver(rx, out.pos))
+                    return false;
+
+                ended = !rc;
+
+                if(in.pos == in.size && (ended || out.pos < out.size))
+                    return true;
+            }
+        }
+#endif
+    };
+
+}
+
+
+#endif
@@ -37,7 +37,7 @@ namespace curlhttp{
     struct default_reader<buffer_t<T>>{
         std::size_t operator()(buffer_t<T>& buffer, char* cbuf, std::size_t size, std::size_t nmemb){
             std::size_t buffer_size = size * nmemb;
-            std::size_t nread = std::min(buffer.size(), buffer_size);
+            std::size_t nread = std::min(buffer.pending(), buffer_size);
             std::memcpy(cbuf, &buffer.container[buffer.read], nread);
             buffer.read += nread;
             return nread;
@@ -84,7 +84,7 @@ namespace curlhttp{
 
     template<>
     struct default_seeker<std::ifstream>{
-        int operator()(std::iostream& stream, curl_off_t offset, int origin){
+        int operator()(std::ifstream& stream, curl_off_t offset, int origin){
             if(stream.seekg(offset, detail::curlseek2std(origin)))
                 return CURL_SEEKFUNC_OK;
 
@@ -106,7 +106,7 @@ namespace curlhttp{
 
     template<>
     struct default_seeker<std::istringstream>{
-        int operator()(std::iostream& stream, curl_off_t offset, int origin){
+        int operator()(std::istringstream& stream, curl_off_t offset, int origin){
             if(stream.seekg(offset, detail::curlseek2std(origin)))
                 return CURL_SEEKFUNC_OK;
 
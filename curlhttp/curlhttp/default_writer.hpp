@@ -2,7 +2,9 @@
 #define CURLHTTP_DEFAULT_WRITER_T_HPP
 
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -26,11 +28,22 @@ namespace curlhttp{
 
     template<typename T, typename... Args, template<typename, typename...> class Container>
     struct default_writer<Container<T, Args...>>{
+        // Upper bound for reserving from an announced body size; Content-Length is untrusted, larger bodies grow as they arrive.
+        std::size_t max_reserve{16 << 20};
+
         std::size_t operator()(Container<T, Args...>& container, const char* buffer, std::size_t size, std::size_t nmemb){
             std::size_t buffer_size = size * nmemb;
             container.insert(container.end(), buffer, buffer + buffer_size);
             return buffer_size;
         }
+
+        template<typename C = Container<T, Args...>>
+        auto expect(C& container, std::uint64_t size) -> decltype(container.reserve(std::size_t{}), void()){
+            std::size_t n = (std::size_t)std::min<std::uint64_t>(size, max_reserve);
+
+            if(n <= container.max_size() - container.size())
+                container.reserve(container.size() + n);
+        }
     };
 
 
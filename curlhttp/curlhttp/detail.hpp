@@ -2,9 +2,14 @@
 #define CURLHTTP_DETAIL_HPP
 
 
+#include <cstdint>
+#include <functional>
 #include <ios>
 #include <istream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <cassert>
@@ -71,6 +76,79 @@ namespace detail{
         assert(((void)"curl specific implementation error", false));
     }
 
+
+    template<typename T, typename = void>
+    struct has_content_encoding : std::false_type {};
+
+    template<typename T>
+    struct has_content_encoding<T, std::void_t<decltype(std::declval<T&>().content_encoding()),
+                                               decltype(std::declval<T&>().restart())>> : std::true_type {};
+
+
+    template<typename T, typename = void>
+    struct is_decoding_writer : std::false_type {};
+
+    template<typename T>
+    struct is_decoding_writer<T, std::void_t<decltype(std::declval<T&>().content_encoding(std::string_view{})),
+                                             decltype(std::declval<T&>().restart())>> : std::true_type {};
+
+
+    template<typename T, typename = void>
+    struct has_expect : std::false_type {};
+
+    template<typename T>
+    struct has_expect<T, std::void_t<decltype(std::declval<T&>().expect(std::uint64_t{}))>> : std::true_type {};
+
+
+    template<typename Writer, typename RX, typename = void>
+    struct has_writer_expect : std::false_type {};
+
+    template<typename Writer, typename RX>
+    struct has_writer_expect<Writer, RX, std::void_t<decltype(std::declval<Writer&>().expect(std::declval<RX&>(), std::uint64_t{}))>> : std::true_type {};
+
+
+    template<typename T, typename = void>
+    struct has_readable : std::false_type {};
+
+    template<typename T>
+    struct has_readable<T, std::void_t<decltype(std::declval<const T&>().readable())>> : std::true_type {};
+
+
+    template<typename T, typename = void>
+    struct has_writable : std::false_type {};
+
+    template<typename T>
+    struct has_writable<T, std::void_t<decltype(std::declval<const T&>().writable())>> : std::true_type {};
+
+
+    template<typename T, typename = void>
+    struct has_notifier : std::false_type {};
+
+    template<typename T>
+    struct has_notifier<T, std::void_t<decltype(std::declval<T&>().set_notifier(std::function<void()>{}))>> : std::true_type {};
+
+
+    template<typename T, typename = void>
+    struct has_restart : std::false_type {};
+
+    template<typename T>
+    struct has_restart<T, std::void_t<decltype(std::declval<T&>().restart())>> : std::true_type {};
+
+
+    template<typename T, typename = void>
+    struct has_close : std::false_type {};
+
+    template<typename T>
+    struct has_close<T, std::void_t<decltype(std::declval<T&>().close()),
+                                    decltype(std::declval<const T&>().closed())>> : std::true_type {};
+
+
+    template<typename T, typename = void>
+    struct has_finish : std::false_type {};
+
+    template<typename T>
+    struct has_finish<T, std::void_t<decltype(std::declval<T&>().finish())>> : std::true_type {};
+
 }
 }
 
@@ -0,0 +1,103 @@
+#ifndef CURLHTTP_DOWNLOAD_CHECKPOINT_T_HPP
+#define CURLHTTP_DOWNLOAD_CHECKPOINT_T_HPP
+
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "file_t.hpp"
+
+
+namespace curlhttp{
+
+    struct download_checkpoint_t{
+        struct range_t{
+            curl_off_t begin{}, end{-1}, written{};
+        };
+
+        static constexpr const char* magic = "curlhttp-checkpoint 1";
+
+        std::string url, validator;
+        curl_off_t size{-1};
+        std::vector<range_t> ranges;
+
+        bool load(const std::filesystem::path& path){
+            std::ifstream in{path};
+            std::string line;
+
+            *this = {};
+
+            if(!std::getline(in, line) || line != magic)
+                return false;
+
+            while(std::getline(in, line)){
+                std::size_t space = line.find(' ');
+                std::string key = line.substr(0, space);
+                std::string value = space == line.npos ? std::string{} : line.substr(space + 1);
+
+                if(key == "url")
+                    url = value;
+
+                else if(key == "validator")
+                    validator = value;
+
+                else if(key == "size")
+                    size = std::stoll(value);
+
+                else if(key == "range"){
+                    range_t range;
+                    std::istringstream stream{value};
+
+                    if(!(stream >> range.begin >> range.end >> range.written))
+                        return false;
+
+                    ranges.push_back(range);
+                }
+            }
+
+            return url.size() && validator.size() && size > 0 && ranges.size();
+        }
+
+        void save(const std::filesystem::path& path) const{
+            std::ostringstream out;
+
+            out << magic << '\n'
+                << "url " << url << '\n'
+                << "validator " << validator << '\n'
+                << "size " << size << '\n';
+
+            for(const auto& range : ranges)
+                out << "range " << range.begin << ' ' << range.end << ' ' << range.written << '\n';
+
+            std::string data = out.str();
+            std::filesystem::path temporary{path};
+            temporary += ".tmp";
+
+            {
+                file_t file{temporary, true};
+
+                if(file.write_at(data.data(), data.size(), 0) != data.size())
+                    throw curl_error{make_error_code(CURLE_WRITE_ERROR), "Cannot write checkpoint"};
+
+                file.sync();
+            }
+
+            std::filesystem::rename(temporary, path);
+        }
+
+        static void remove(const std::filesystem::path& path){
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    };
+
+}
+
+
+#endif
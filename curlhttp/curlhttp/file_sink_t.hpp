@@ -0,0 +1,147 @@
+#ifndef CURLHTTP_FILE_SINK_T_HPP
+#define CURLHTTP_FILE_SINK_T_HPP
+
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+
+#include "default_writer.hpp"
+#include "file_t.hpp"
+
+
+namespace curlhttp{
+
+    // finish() writes the staged tail, trims the preallocation and syncs, throwing on failure.
+    // http_request calls it after a successful transfer; custom flows call it themselves.
+    // A sink destroyed without finish() drops the tail.
+    class file_sink_t{
+    public:
+        static constexpr std::size_t alignment = 4096;
+
+        struct settings_t{
+            bool direct{};
+            std::size_t staging_size{1 << 20};
+            std::uint64_t sync_interval{};
+        };
+
+        explicit file_sink_t(const std::filesystem::path& path)
+            : file{path, true}{
+            init();
+        }
+
+        file_sink_t(const std::filesystem::path& path, const settings_t& s)
+            : file{path, true}, settings{s}{
+            init();
+        }
+
+        file_sink_t(file_sink_t&& ) = default;
+
+        void expect(std::uint64_t size){
+            if(size > expected){
+                expected = size;
+                file.preallocate(size);
+            }
+        }
+
+        std::size_t write(const char* data, std::size_t size){
+            std::size_t written = stage(data, size);
+            position += written;
+            return written;
+        }
+
+        void finish(){
+            if(!file.is_open())
+                return;
+
+            if(staged){
+                if(direct_io)
+                    direct_io = !file.set_direct(false);
+
+                if(file.write_at(staging, staged, position - staged) != staged)
+                    throw curl_error{make_error_code(CURLE_WRITE_ERROR), "Cannot write file"};
+
+                staged = 0;
+            }
+
+            if(expected > position)
+                file.resize(position);
+
+            file.sync();
+            file.close();
+            unsynced = 0;
+        }
+
+        std::uint64_t size() const{
+            return position;
+        }
+
+        bool direct() const{
+            return direct_io;
+        }
+
+    private:
+        file_t file;
+        settings_t settings;
+        std::unique_ptr<char[]> storage;
+        char* staging{};
+        std::size_t staged{};
+        std::uint64_t position{}, expected{}, unsynced{};
+        bool direct_io{};
+
+        void init(){
+            settings.staging_size = std::max(alignment, settings.staging_size / alignment * alignment);
+            storage = std::make_unique<char[]>(settings.staging_size + alignment);
+
+            void* p = storage.get();
+            std::size_t space = settings.staging_size + alignment;
+            staging = (char*)std::align(alignment, settings.staging_size, p, space);
+
+            if(settings.direct)
+                direct_io = file.set_direct(true);
+        }
+
+        std::size_t stage(const char* data, std::size_t size){
+            std::size_t consumed{};
+
+            while(consumed < size){
+                std::size_t n = std::min(size - consumed, settings.staging_size - staged);
+                std::memcpy(staging + staged, data + consumed, n);
+
+                staged += n;
+                consumed += n;
+
+                if(staged == settings.staging_size){
+                    std::uint64_t offset = position + consumed - staged;
+
+                    if(file.write_at(staging, staged, offset) != staged)
+                        return 0;
+
+                    unsynced += staged;
+                    staged = 0;
+
+                    if(settings.sync_interval && unsynced >= settings.sync_interval){
+                        file.sync();
+                        unsynced = 0;
+                    }
+                }
+            }
+
+            return consumed;
+        }
+    };
+
+
+    template<>
+    struct default_writer<file_sink_t>{
+        std::size_t operator()(file_sink_t& sink, const char* buffer, std::size_t size, std::size_t nmemb){
+            return sink.write(buffer, size * nmemb);
+        }
+    };
+
+}
+
+
+#endif
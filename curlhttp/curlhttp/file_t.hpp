@@ -0,0 +1,262 @@
+#ifndef CURLHTTP_FILE_T_HPP
+#define CURLHTTP_FILE_T_HPP
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <Windows.h>
+#endif
+
+#include <curl/curl.h>
+
+#include "curl_error.hpp"
+
+
+namespace curlhttp{
+
+    class file_t{
+    public:
+#ifndef _WIN32
+        using native_handle_t = int;
+        static constexpr native_handle_t invalid_handle = -1;
+#else
+        using native_handle_t = HANDLE;
+        inline static const native_handle_t invalid_handle = INVALID_HANDLE_VALUE;
+#endif
+
+        file_t() = default;
+
+        explicit file_t(const std::filesystem::path& path, bool truncate = false){
+            open(path, truncate);
+        }
+
+        file_t(file_t&& rhs) noexcept
+            : handle{rhs.handle}{
+            rhs.handle = invalid_handle;
+        }
+
+        file_t& operator= (file_t&& rhs) noexcept{
+            if(this != &rhs){
+                close();
+                handle = rhs.handle;
+                rhs.handle = invalid_handle;
+            }
+
+            return *this;
+        }
+
+        ~file_t(){
+            close();
+        }
+
+        void open(const std::filesystem::path& path, bool truncate = false){
+            close();
+
+#ifndef _WIN32
+            handle = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+#else
+            handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                 truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+
+            if(handle == invalid_handle)
+                throw_error("Cannot open file");
+        }
+
+        void create_private(const std::filesystem::path& path){
+            close();
+
+#ifndef _WIN32
+            handle = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+#else
+            handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                                 CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+
+            if(handle == invalid_handle)
+                throw_error("Cannot create file");
+        }
+
+        void open_read(const std::filesystem::path& path){
+            close();
+
+#ifndef _WIN32
+            handle = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#else
+            handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+
+            if(handle == invalid_handle)
+                throw curl_error{make_error_code(CURLE_READ_ERROR), "Cannot open file"};
+        }
+
+        void close(){
+            if(handle == invalid_handle)
+                return;
+
+#ifndef _WIN32
+            ::close(handle);
+#else
+            CloseHandle(handle);
+#endif
+
+            handle = invalid_handle;
+        }
+
+        bool is_open() const{
+            return handle != invalid_handle;
+        }
+
+        native_handle_t native() const{
+            return handle;
+        }
+
+        std::uint64_t size() const{
+#ifndef _WIN32
+            struct stat st{};
+
+            if(fstat(handle, &st))
+                throw_error("Cannot stat file");
+
+            return (std::uint64_t)st.st_size;
+#else
+            LARGE_INTEGER result{};
+
+            if(!GetFileSizeEx(handle, &result))
+                throw_error("Cannot stat file");
+
+            return (std::uint64_t)result.QuadPart;
+#endif
+        }
+
+        void resize(std::uint64_t size){
+#ifndef _WIN32
+            if(ftruncate(handle, (off_t)size))
+                throw_error("Cannot resize file");
+#else
+            FILE_END_OF_FILE_INFO info{};
+            info.EndOfFile.QuadPart = (LONGLONG)size;
+
+            if(!SetFileInformationByHandle(handle, FileEndOfFileInfo, &info, sizeof(info)))
+                throw_error("Cannot resize file");
+#endif
+        }
+
+        void preallocate(std::uint64_t size){
+#if defined(__linux__)
+            if(posix_fallocate(handle, 0, (off_t)size) == 0)
+                return;
+#endif
+            if(this->size() < size)
+                resize(size);
+        }
+
+        bool set_direct(bool enable){
+#if defined(__linux__) && defined(O_DIRECT)
+            int flags = fcntl(handle, F_GETFL);
+
+            if(flags < 0)
+                return false;
+
+            flags = enable ? flags | O_DIRECT : flags & ~O_DIRECT;
+            return fcntl(handle, F_SETFL, flags) == 0;
+#else
+            return !enable;
+#endif
+        }
+
+        std::size_t write_at(const char* data, std::size_t size, std::uint64_t offset){
+            std::size_t written{};
+
+            while(written < size){
+#ifndef _WIN32
+                ssize_t n = pwrite(handle, data + written, size - written, (off_t)(offset + written));
+
+                if(n < 0 && errno == EINTR)
+                    continue;
+
+                if(n <= 0)
+                    break;
+#else
+                OVERLAPPED overlapped{};
+                DWORD n{};
+                std::uint64_t position = offset + written;
+
+                overlapped.Offset = (DWORD)position;
+                overlapped.OffsetHigh = (DWORD)(position >> 32);
+
+                if(!WriteFile(handle, data + written, (DWORD)std::min<std::size_t>(size - written, 1u << 30), &n, &overlapped) || !n)
+                    break;
+#endif
+
+                written += (std::size_t)n;
+            }
+
+            return written;
+        }
+
+        std::size_t read_at(char* data, std::size_t size, std::uint64_t offset) const{
+            std::size_t nread{};
+
+            while(nread < size){
+#ifndef _WIN32
+                ssize_t n = pread(handle, data + nread, size - nread, (off_t)(offset + nread));
+
+                if(n < 0 && errno == EINTR)
+                    continue;
+
+                if(n <= 0)
+                    break;
+#else
+                OVERLAPPED overlapped{};
+                DWORD n{};
+                std::uint64_t position = offset + nread;
+
+                overlapped.Offset = (DWORD)position;
+                overlapped.OffsetHigh = (DWORD)(position >> 32);
+
+                if(!ReadFile(handle, data + nread, (DWORD)std::min<std::size_t>(size - nread, 1u << 30), &n, &overlapped) || !n)
+                    break;
+#endif
+
+                nread += (std::size_t)n;
+            }
+
+            return nread;
+        }
+
+        void sync(){
+#if defined(__linux__)
+            if(fdatasync(handle))
+                throw_error("Cannot sync file");
+#elif !defined(_WIN32)
+            if(fsync(handle))
+                throw_error("Cannot sync file");
+#else
+            if(!FlushFileBuffers(handle))
+                throw_error("Cannot sync file");
+#endif
+        }
+
+    private:
+        native_handle_t handle{invalid_handle};
+
+        [[noreturn]] static void throw_error(const char* message){
+            throw curl_error{make_error_code(CURLE_WRITE_ERROR), message};
+        }
+    };
+
+}
+
+
+#endif
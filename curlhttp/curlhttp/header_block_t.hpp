@@ -0,0 +1,301 @@
+#ifndef CURLHTTP_HEADER_BLOCK_T_HPP
+#define CURLHTTP_HEADER_BLOCK_T_HPP
+
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "header_names.hpp"
+#include "response_t.hpp"
+#include "status_code.hpp"
+#include "utility.hpp"
+
+
+namespace curlhttp{
+
+    class header_block_t;
+
+
+    struct field_view_t{
+        std::string_view name, value;
+    };
+
+
+    class header_view_t{
+    public:
+        header_view_t(const header_block_t& blk, std::size_t idx)
+            : block{&blk}, index{idx} {}
+
+        std::string_view raw() const;
+        std::string_view version() const;
+        status_code code() const;
+        std::string_view message() const;
+
+        bool complete() const;
+        std::size_t size() const;
+        field_view_t operator[](std::size_t n) const;
+
+        std::ptrdiff_t find(const header_name_t& name) const;
+        std::optional<std::string_view> get(const header_name_t& name) const;
+
+        response_t response() const;
+
+    private:
+        const header_block_t* block;
+        std::size_t index;
+    };
+
+
+    class header_block_t{
+        friend class header_view_t;
+
+    public:
+        enum class line_t : char{
+            status, field, end, other
+        };
+
+        line_t append(const char* data, std::size_t size){
+            if(entries.empty() || entries.back().complete){
+                entries.emplace_back();
+                entries.back().raw.offset = (std::uint32_t)block.size();
+                entries.back().first_field = (std::uint32_t)fields.size();
+            }
+
+            auto& entry = entries.back();
+            auto offset = (std::uint32_t)block.size();
+            bool first = !entry.raw.size;
+
+            if(size && is_space(data[0]) && entry.nfields && field_end == block.size())
+                return fold(entry, data, size);
+
+            block.append(data, size);
+            entry.raw.size += (std::uint32_t)size;
+
+            while(size && (data[size - 1] == '\n' || data[size - 1] == '\r'))
+                --size;
+
+            if(!size){
+                entry.complete = true;
+                return line_t::end;
+            }
+
+            std::string_view line{data, size};
+
+            if(first && line.substr(0, 5) == "HTTP/"){
+                parse_status_line(entry, line, offset);
+                return line_t::status;
+            }
+
+            std::size_t colon = line.find(':');
+
+            if(colon == line.npos || !colon)
+                return line_t::other;
+
+            std::size_t name_end = colon;
+            std::size_t value_begin = colon + 1;
+
+            while(name_end && is_space(line[name_end - 1]))
+                --name_end;
+
+            while(value_begin < size && is_space(line[value_begin]))
+                ++value_begin;
+
+            fields.push_back({{offset, (std::uint32_t)name_end}, {offset + (std::uint32_t)value_begin, (std::uint32_t)(size - value_begin)}});
+            hashes.push_back(header_hash(line.substr(0, name_end)));
+            ++entry.nfields;
+            field_end = block.size();
+
+            return line_t::field;
+        }
+
+        void clear(){
+            field_end = 0;
+            block.clear();
+            fields.clear();
+            hashes.clear();
+            entries.clear();
+        }
+
+        bool empty() const{
+            return entries.empty();
+        }
+
+        std::size_t size() const{
+            return entries.size();
+        }
+
+        header_view_t operator[](std::size_t n) const{
+            return {*this, n};
+        }
+
+        header_view_t back() const{
+            return {*this, entries.size() - 1};
+        }
+
+        std::string_view raw() const{
+            return block;
+        }
+
+    private:
+        struct span_t{
+            std::uint32_t offset{}, size{};
+        };
+
+        struct field_span_t{
+            span_t name, value;
+        };
+
+        struct entry_t{
+            span_t raw, version, message;
+            status_code code{};
+            std::uint32_t first_field{}, nfields{};
+            bool complete{};
+        };
+
+        std::string block;
+        std::vector<field_span_t> fields;
+        std::vector<std::uint32_t> hashes;
+        std::vector<entry_t> entries;
+        std::size_t field_end{};
+
+        static bool is_space(char c){
+            return c == ' ' || c == '\t';
+        }
+
+        line_t fold(entry_t& entry, const char* data, std::size_t size){
+            std::size_t length = size;
+
+            while(length && (data[length - 1] == '\n' || data[length - 1] == '\r'))
+                --length;
+
+            std::size_t begin{};
+
+            while(begin < length && is_space(data[begin]))
+                ++begin;
+
+            auto& value = fields.back().value;
+            block.resize(value.offset + value.size);
+
+            if(begin < length){
+                if(value.size){
+                    block += ' ';
+                    ++value.size;
+                }
+
+                block.append(data + begin, length - begin);
+                value.size += (std::uint32_t)(length - begin);
+            }
+
+            block.append(data + length, size - length);
+            entry.raw.size = (std::uint32_t)(block.size() - entry.raw.offset);
+            field_end = block.size();
+
+            return line_t::field;
+        }
+
+        static void parse_status_line(entry_t& entry, std::string_view line, std::uint32_t offset){
+            std::size_t pos = line.find_first_of(" \t");
+            entry.version = {offset, (std::uint32_t)std::min(pos, line.size())};
+
+            if(pos == line.npos)
+                return;
+
+            while(pos < line.size() && is_space(line[pos]))
+                ++pos;
+
+            unsigned value{};
+            auto result = std::from_chars(line.data() + pos, line.data() + line.size(), value);
+
+            if(result.ec != std::errc{})
+                return;
+
+            entry.code = (status_code)value;
+            pos = (std::size_t)(result.ptr - line.data());
+
+            while(pos < line.size() && is_space(line[pos]))
+                ++pos;
+
+            entry.message = {offset + (std::uint32_t)pos, (std::uint32_t)(line.size() - pos)};
+        }
+
+        std::string_view view(const span_t& span) const{
+            return std::string_view{block}.substr(span.offset, span.size);
+        }
+    };
+
+
+    inline std::string_view header_view_t::raw() const{
+        return block->view(block->entries[index].raw);
+    }
+
+    inline std::string_view header_view_t::version() const{
+        return block->view(block->entries[index].version);
+    }
+
+    inline status_code header_view_t::code() const{
+        return block->entries[index].code;
+    }
+
+    inline std::string_view header_view_t::message() const{
+        return block->view(block->entries[index].message);
+    }
+
+    inline bool header_view_t::complete() const{
+        return block->entries[index].complete;
+    }
+
+    inline std::size_t header_view_t::size() const{
+        return block->entries[index].nfields;
+    }
+
+    inline field_view_t header_view_t::operator[](std::size_t n) const{
+        const auto& field = block->fields[block->entries[index].first_field + n];
+        return {block->view(field.name), block->view(field.value)};
+    }
+
+    inline std::ptrdiff_t header_view_t::find(const header_name_t& name) const{
+        const auto& entry = block->entries[index];
+        const std::uint32_t* hashes = block->hashes.data() + entry.first_field;
+
+        for(std::size_t n{}; n < entry.nfields; ++n){
+            if(hashes[n] == name.hash && ascii_icase_compare(operator[](n).name, name.name))
+                return (std::ptrdiff_t)n;
+        }
+
+        return -1;
+    }
+
+    inline std::optional<std::string_view> header_view_t::get(const header_name_t& name) const{
+        std::ptrdiff_t n = find(name);
+
+        if(n < 0)
+            return {};
+
+        return operator[]((std::size_t)n).value;
+    }
+
+    inline response_t header_view_t::response() const{
+        response_t result;
+
+        result.version = version();
+        result.code = code();
+        result.message = message();
+        result.fields.reserve(size());
+
+        for(std::size_t n{}; n < size(); ++n){
+            auto field = operator[](n);
+            result.fields.push_back({std::string{field.name}, std::string{field.value}});
+        }
+
+        return result;
+    }
+
+}
+
+
+#endif
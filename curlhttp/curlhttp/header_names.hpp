@@ -0,0 +1,56 @@
+#ifndef CURLHTTP_HEADER_NAMES_HPP
+#define CURLHTTP_HEADER_NAMES_HPP
+
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "utility.hpp"
+
+
+namespace curlhttp{
+
+    struct header_name_t{
+        std::string_view name;
+        std::uint32_t hash;
+
+        constexpr header_name_t(std::string_view n)
+            : name{n}, hash{header_hash(n)} {}
+
+        constexpr header_name_t(const char* n)
+            : header_name_t{std::string_view{n}} {}
+
+        header_name_t(const std::string& n)
+            : header_name_t{std::string_view{n}} {}
+    };
+
+
+    namespace header_names{
+        inline constexpr header_name_t accept_ranges{"Accept-Ranges"};
+        inline constexpr header_name_t age{"Age"};
+        inline constexpr header_name_t cache_control{"Cache-Control"};
+        inline constexpr header_name_t connection{"Connection"};
+        inline constexpr header_name_t content_disposition{"Content-Disposition"};
+        inline constexpr header_name_t content_encoding{"Content-Encoding"};
+        inline constexpr header_name_t content_length{"Content-Length"};
+        inline constexpr header_name_t content_range{"Content-Range"};
+        inline constexpr header_name_t content_type{"Content-Type"};
+        inline constexpr header_name_t date{"Date"};
+        inline constexpr header_name_t etag{"ETag"};
+        inline constexpr header_name_t expires{"Expires"};
+        inline constexpr header_name_t last_modified{"Last-Modified"};
+        inline constexpr header_name_t location{"Location"};
+        inline constexpr header_name_t retry_after{"Retry-After"};
+        inline constexpr header_name_t server{"Server"};
+        inline constexpr header_name_t set_cookie{"Set-Cookie"};
+        inline constexpr header_name_t traceparent{"traceparent"};
+        inline constexpr header_name_t transfer_encoding{"Transfer-Encoding"};
+        inline constexpr header_name_t vary{"Vary"};
+        inline constexpr header_name_t www_authenticate{"WWW-Authenticate"};
+    }
+
+}
+
+
+#endif
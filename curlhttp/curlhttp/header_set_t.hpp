@@ -0,0 +1,115 @@
+#ifndef CURLHTTP_HEADER_SET_T_HPP
+#define CURLHTTP_HEADER_SET_T_HPP
+
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "detail.hpp"
+#include "field_t.hpp"
+#include "utility.hpp"
+
+
+namespace curlhttp{
+
+    class header_set_t{
+    public:
+        header_set_t() = default;
+
+        header_set_t(std::initializer_list<field_t> fields)
+            : header_set_t{std::vector<field_t>{fields}} {}
+
+        explicit header_set_t(std::vector<field_t> fields){
+            if(fields.size())
+                data = build(std::move(fields));
+        }
+
+        header_set_t with(const std::vector<field_t>& additions) const{
+            if(additions.empty())
+                return *this;
+
+            if(!data)
+                return header_set_t{additions};
+
+            std::vector<field_t> merged;
+            merged.reserve(data->fields.size() + additions.size());
+
+            for(const auto& field : data->fields){
+                bool replaced = std::any_of(additions.begin(), additions.end(), [&field](const field_t& f){
+                    return ascii_icase_compare(f.name, field.name);
+                });
+
+                if(!replaced)
+                    merged.push_back(field);
+            }
+
+            merged.insert(merged.end(), additions.begin(), additions.end());
+
+            header_set_t result;
+            result.data = build(std::move(merged));
+            return result;
+        }
+
+        header_set_t without(std::string_view name) const{
+            if(!data)
+                return *this;
+
+            std::vector<field_t> kept;
+            kept.reserve(data->fields.size());
+
+            std::copy_if(data->fields.begin(), data->fields.end(), std::back_inserter(kept), [name](const field_t& field){
+                return !ascii_icase_compare(field.name, name);
+            });
+
+            if(kept.size() == data->fields.size())
+                return *this;
+
+            return header_set_t{std::move(kept)};
+        }
+
+        const std::vector<field_t>& fields() const{
+            static const std::vector<field_t> empty_fields;
+            return data ? data->fields : empty_fields;
+        }
+
+        curl_slist* native() const{
+            return data ? data->list.get() : nullptr;
+        }
+
+        bool empty() const{
+            return !data;
+        }
+
+        bool same(const header_set_t& rhs) const{
+            return data == rhs.data;
+        }
+
+    private:
+        struct data_t{
+            std::vector<field_t> fields;
+            std::unique_ptr<curl_slist, detail::curl_slist_deleter> list;
+        };
+
+        std::shared_ptr<const data_t> data;
+
+        static std::shared_ptr<const data_t> build(std::vector<field_t> fields){
+            auto result = std::make_shared<data_t>();
+
+            for(const auto& field : fields)
+                result->list.reset(curl_slist_append(result->list.release(), (field.name + ": " + field.value).c_str()));
+
+            result->fields = std::move(fields);
+            return result;
+        }
+    };
+
+}
+
+
+#endif
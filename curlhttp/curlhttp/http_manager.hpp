@@ -4,6 +4,7 @@
 
 #include "async_handle.hpp"
 #include "http_request.hpp"
+#include "latency_histogram.hpp"
 
 
 namespace curlhttp{
@@ -14,20 +15,29 @@ namespace curlhttp{
             using http_error_callback_t = std::function<void(const std::error_code& code)>;
             using status_code_callback_t = std::function<bool(status_code)>;
             using response_callback_t = std::function<bool(const response_t& )>;
+            using header_callback_t = std::function<bool(const header_view_t& )>;
 
             std::string user_agent{get_default_user_agent()};
+            header_set_t default_headers;
             http_error_callback_t http_error_callback;
             status_code_callback_t status_code_callback;
             response_callback_t response_callback;
+            header_callback_t header_callback;
+            accept_encoding_t accept_encoding{accept_encoding_t::none};
+            long stream_weight{};
             bool throw_http_errors{true};
 
             template<typename T>
             void apply(T& request) const{
                 request.user_agent = user_agent;
+                request.default_headers = default_headers;
 
                 request.http_error_callback = http_error_callback;
                 request.status_code_callback = status_code_callback;
                 request.response_callback = response_callback;
+                request.header_callback = header_callback;
+                request.accept_encoding = accept_encoding;
+                request.stream_weight = stream_weight;
                 request.throw_http_errors = throw_http_errors;
             }
         };
@@ -41,6 +51,11 @@ namespace curlhttp{
 
         virtual ~http_manager() {}
 
+        void set_throw_errors(bool enable) override{
+            async_handle::set_throw_errors(enable);
+            http_prototype.throw_http_errors = enable;
+        }
+
         template<typename T, typename... Args>
         T& make_rx_buffer(Args&&... arguments){
             auto bufp = buffer_ptr{new T(std::forward<Args>(arguments)...), [](void* p){
@@ -86,6 +101,56 @@ namespace curlhttp{
             }
         }
 
+        /*** PREWARM ***/
+
+        std::size_t prewarm(const std::string& url, std::size_t n){
+            std::vector<std::unique_ptr<head_request>> warmers;
+            std::vector<curl_base*> subset;
+            std::size_t failed{};
+
+            struct guard_t{
+                http_manager& self;
+                std::vector<std::unique_ptr<head_request>>& warmers;
+
+                ~guard_t(){
+                    for(auto& p : warmers){
+                        try{
+                            self.remove(*p);
+                        }
+
+                        catch(...) {}
+                    }
+                }
+            } guard{*this, warmers};
+
+            for(std::size_t i{}; i < n; ++i){
+                warmers.push_back(std::make_unique<head_request>(make_url(url)));
+                auto& p = warmers.back();
+
+                add(*p);
+                subset.push_back(p.get());
+
+                p->user_agent = http_prototype.user_agent;
+                p->default_headers = http_prototype.default_headers;
+                p->set_option(CURLOPT_FRESH_CONNECT, true);
+                p->easy_error_callback = [&failed](const std::error_code& ){ ++failed; };
+                p->done_callback = {};
+                p->throw_easy_errors = false;
+                p->throw_http_errors = false;
+                p->throw_callback_exceptions = false;
+            }
+
+            perform_only(subset);
+            return n - failed;
+        }
+
+        template<typename Function>
+        std::size_t prewarm(const std::string& url, std::size_t n, Function&& callback){
+            std::size_t warm = prewarm(url, n);
+            std::forward<Function>(callback)(warm);
+            return warm;
+        }
+
         /*** TRACE ***/
 
         std::shared_ptr<trace_request> trace(const std::string& url){
@@ -264,17 +329,35 @@ namespace curlhttp{
             return p;
         }
 
+        const latency_stats& get_latency_stats() const{
+            return *stats;
+        }
+
+        latency_snapshot_t latency_snapshot() const{
+            return stats->snapshot();
+        }
+
     protected:
         virtual url_t make_url(const std::string& s) const{
             return s;
         }
 
+        void complete(curl_base& request) override{
+            async_handle::complete(request);
+
+            const auto& info = request.get_transfer_info();
+            auto host = request.url.get(CURLUPART_HOST);
+
+            stats->record(host ? *host : std::string{}, info.method, info);
+        }
+
     private:
         using buffer_ptr = std::unique_ptr<void, void(*)(void*)>;
         using curl_ptr = std::shared_ptr<curl_base>;
 
         std::vector<buffer_ptr> rx_buffers, tx_buffers;
         std::vector<curl_ptr> handles;
+        std::unique_ptr<latency_stats> stats{std::make_unique<latency_stats>()};
     };
 
 }
@@ -2,9 +2,13 @@
 #define CURLHTTP_HTTP_REQUEST_HPP
 
 
+#include <charconv>
 #include <filesystem>
 
 #include "curl_handle.hpp"
+#include "decoding_writer.hpp"
+#include "header_set_t.hpp"
+#include "tracing.hpp"
 #include "status_code.hpp"
 #include "method_t.hpp"
 #include "utility.hpp"
@@ -21,55 +25,86 @@ namespace curlhttp{
     /*** HTTP REQUEST ***/
 
     template<method_t Method, typename RX, typename TX,
-             typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>>
-    class http_request : public curl_handle<RX, TX, Writer, Reader, Seeker>{
+             typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>,
+             typename Hooks = function_hooks>
+    class http_request : public curl_handle<RX, TX, Writer, Reader, Seeker, Hooks>{
     public:
         static constexpr method_t method = Method;
         inline static const std::string default_user_agent = get_default_user_agent();
 
         using status_code_callback_t = std::function<bool(status_code)>;
         using response_callback_t = std::function<bool(const response_t& )>;
+        using header_callback_t = std::function<bool(const header_view_t& )>;
 
-        using curl_handle<RX, TX, Writer, Reader, Seeker>::curl_handle;
+        using curl_handle<RX, TX, Writer, Reader, Seeker, Hooks>::curl_handle;
 
         http_request(http_request&& ) = default;
         http_request& operator= (http_request&& ) = default;
 
         virtual ~http_request() {}
 
+        header_set_t default_headers;
         std::vector<field_t> headers;
         std::string user_agent{default_user_agent};
         curl_base::error_callback_t http_error_callback;
         status_code_callback_t status_code_callback;
         response_callback_t response_callback;
+        header_callback_t header_callback;
+        std::shared_ptr<tracer> tracing;
+        accept_encoding_t accept_encoding{accept_encoding_t::none};
+        long stream_weight{};
         bool throw_http_errors{true};
 
         void init() override{
-            curl_handle<RX, TX, Writer, Reader, Seeker>::init();
+            curl_handle<RX, TX, Writer, Reader, Seeker, Hooks>::init();
             code = (status_code)0;
 
             curl_base::set_option(CURLOPT_FOLLOWLOCATION, true);
             curl_base::set_option(CURLOPT_USERAGENT, user_agent.c_str());
 
+            if(tracing)
+                start_span();
+
+            if constexpr(detail::has_content_encoding<TX>::value)
+                setup_content_encoding();
+
+            setup_accept_encoding();
+
+            if(stream_weight)
+                curl_base::set_option(CURLOPT_STREAM_WEIGHT, stream_weight);
+
             setup_headers();
         }
 
         void exit() override{
-            curl_handle<RX, TX, Writer, Reader, Seeker>::exit();
+            if constexpr(detail::has_finish<RX>::value)
+                if(result().ok())
+                    this->rx_buffer.finish();
+
+            curl_handle<RX, TX, Writer, Reader, Seeker, Hooks>::exit();
 
             if((bool)code)
                 handle_status_code();
         }
 
         void reset() override{
-            curl_handle<RX, TX, Writer, Reader, Seeker>::reset();
+            curl_handle<RX, TX, Writer, Reader, Seeker, Hooks>::reset();
 
+            default_headers = {};
             headers.clear();
+            prepared_headers = {};
+            prepared_base = {};
+            prepared_fields.clear();
             user_agent = default_user_agent;
 
             http_error_callback = {};
             status_code_callback = {};
             response_callback = {};
+            header_callback = {};
+            tracing.reset();
+            span.reset();
+            accept_encoding = accept_encoding_t::none;
+            stream_weight = 0;
 
             throw_http_errors = true;
         }
@@ -90,27 +125,164 @@ namespace curlhttp{
             return code;
         }
 
+        result_t result() const override{
+            return {curl_base::get_last_error(), code};
+        }
+
     protected:
         void setup_header_download() override{
             curl_base::set_option(CURLOPT_HEADERDATA, this);
             curl_base::set_option(CURLOPT_HEADERFUNCTION, &http_request::write_header_callback);
         }
 
+    protected:
+        void collect() override{
+            curl_handle<RX, TX, Writer, Reader, Seeker, Hooks>::collect();
+
+            if constexpr(detail::is_decoding_writer<Writer>::value)
+                if(!curl_base::get_last_error() && !this->get_writer().complete())
+                    curl_base::set_last_error(make_error_code(CURLE_BAD_CONTENT_ENCODING));
+
+            if(span)
+                end_span();
+        }
+
     private:
+        struct encoding_header_t{
+            std::string line;
+            curl_slist node{};
+        };
+
         status_code code;
-        std::unique_ptr<curl_slist, detail::curl_slist_deleter> headers_list;
+        header_set_t prepared_headers, prepared_base;
+        std::vector<field_t> prepared_fields;
+        std::optional<span_t> span;
+        std::unique_ptr<traceparent_header_t> traceparent;
+        std::unique_ptr<encoding_header_t> encoding_header;
+
+        void start_span(){
+            span.emplace();
+            span->context = tracing->start();
+            span->parent = tracing->parent;
+            span->start = span_t::clock_type::now();
+        }
+
+        void end_span(){
+            const auto& info = curl_base::get_transfer_info();
+
+            span->end = span_t::clock_type::now();
+            span->name = "HTTP " + (info.method.size() ? info.method : std::string{"request"});
+            char* effective_url{};
+
+            if(curl_easy_getinfo(curl_base::native(), CURLINFO_EFFECTIVE_URL, &effective_url) == CURLE_OK && effective_url)
+                span->url = effective_url;
+
+            span->code = code;
+            span->result = (CURLcode)curl_base::get_last_error().value();
+            span->add_events(info);
+
+            if(tracing)
+                tracing->submit(std::move(*span));
+
+            span.reset();
+        }
+
+        bool on_status(status_code c){
+            if constexpr(std::is_same_v<Hooks, function_hooks>)
+                return !status_code_callback || status_code_callback(c);
+            else
+                return Hooks::status(c);
+        }
+
+        bool on_response(const header_view_t& view){
+            if constexpr(std::is_same_v<Hooks, function_hooks>)
+                return (!header_callback || header_callback(view)) && (!response_callback || response_callback(view.response()));
+            else
+                return Hooks::response(view);
+        }
+
+        void setup_content_encoding(){
+            this->tx_buffer.restart();
+
+            if(!encoding_header)
+                encoding_header = std::make_unique<encoding_header_t>();
+
+            encoding_header->line = std::string{header_names::content_encoding.name} + ": " + this->tx_buffer.content_encoding();
+            encoding_header->node.data = encoding_header->line.data();
+        }
+
+        void setup_accept_encoding(){
+            if constexpr(detail::is_decoding_writer<Writer>::value)
+                this->get_writer().restart();
+
+            switch(accept_encoding){
+                case accept_encoding_t::none:
+                    curl_base::set_option(CURLOPT_ACCEPT_ENCODING, (const char*)nullptr);
+                    break;
+
+                case accept_encoding_t::libcurl:
+                    curl_base::set_option(CURLOPT_ACCEPT_ENCODING, "");
+                    curl_base::set_option(CURLOPT_HTTP_CONTENT_DECODING, 1L);
+                    break;
+
+                case accept_encoding_t::writer:
+                    curl_base::set_option(CURLOPT_ACCEPT_ENCODING, supported_encodings());
+                    curl_base::set_option(CURLOPT_HTTP_CONTENT_DECODING, 0L);
+                    break;
+            }
+        }
 
         void setup_headers(){
-            for(const auto& field : headers)
-                headers_list.reset(curl_slist_append(headers_list.release(), (field.name + ": " + field.value).c_str()));
+            if(!prepared_base.same(default_headers) || prepared_fields != headers){
+                prepared_headers = default_headers.with(headers);
 
-            curl_base::set_option(CURLOPT_HTTPHEADER, headers_list.get());
+                if constexpr(detail::has_content_encoding<TX>::value)
+                    prepared_headers = prepared_headers.without(header_names::content_encoding.name);
+
+                prepared_base = default_headers;
+                prepared_fields = headers;
+            }
+
+            curl_slist* list = prepared_headers.native();
+
+            if constexpr(detail::has_content_encoding<TX>::value){
+                encoding_header->node.next = list;
+                list = &encoding_header->node;
+            }
+
+            if(span && !adopt_traceparent()){
+                if(!traceparent)
+                    traceparent = std::make_unique<traceparent_header_t>();
+
+                span->context.format(traceparent->line + traceparent_header_t::prefix_size);
+                traceparent->node.data = traceparent->line;
+                traceparent->node.next = list;
+                list = &traceparent->node;
+            }
+
+            curl_base::set_option(CURLOPT_HTTPHEADER, list);
+        }
+
+        bool adopt_traceparent(){
+            for(const auto& field : prepared_headers.fields()){
+                if(ascii_icase_compare(field.name, header_names::traceparent.name)){
+                    if(auto context = trace_context_t::parse(field.value))
+                        span->context = *context;
+
+                    return true;
+                }
+            }
+
+            return false;
         }
 
         void handle_status_code(){
             if(is_client_error(code) || is_server_error(code)){
                 auto ec = make_http_error_code(code);
 
+                if(curl_base::debug)
+                    curl_base::debug->failed(curl_base::native());
+
                 if(http_error_callback)
                     http_error_callback(ec);
 
@@ -119,50 +291,86 @@ namespace curlhttp{
             }
         }
 
-        bool get_status_code(const std::string_view& status_line){
-            std::size_t pos = status_line.find_first_of(" \t");
+        void expect_body_size(const header_view_t& view){
+            if(!is_success(view.code()) || view.get(header_names::content_encoding))
+                return;
 
-            if(pos != status_line.npos && pos < status_line.size() - 1 && std::isdigit(status_line[++pos])){
-                code = (status_code)std::stoul(status_line.substr(pos).data());
+            std::uint64_t size{};
 
-                if(status_code_callback)
-                    return status_code_callback(code);
+            if(auto length = view.get(header_names::content_length)){
+                if(!parse_number(*length, size))
+                    return;
             }
 
-            return true;
+            else if(auto range = view.get(header_names::content_range)){
+                if(!parse_content_range(*range, size))
+                    return;
+            }
+
+            else
+                return;
+
+            if constexpr(detail::has_writer_expect<Writer, RX>::value)
+                this->get_writer().expect(this->rx_buffer, size);
+            else
+                this->rx_buffer.expect(size);
         }
 
+        static bool parse_number(std::string_view s, std::uint64_t& value){
+            auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+            return result.ec == std::errc{} && result.ptr == s.data() + s.size();
+        }
+
+        static bool parse_content_range(std::string_view s, std::uint64_t& size){
+            std::uint64_t first{}, last{};
+            std::size_t space = s.find(' ');
+            std::size_t dash = s.find('-');
+            std::size_t slash = s.find('/');
+
+            if(space == s.npos || dash == s.npos || slash == s.npos || !(space < dash && dash < slash))
+                return false;
+
+            if(!parse_number(s.substr(space + 1, dash - space - 1), first) || !parse_number(s.substr(dash + 1, slash - dash - 1), last) || last < first)
+                return false;
+
+            size = last - first + 1;
+            return true;
+        }
 
         static std::size_t write_header_callback(char* buffer, std::size_t sz, std::size_t nmemb, http_request* this_) try{
-            if(this_->rx_callback && !this_->rx_callback(std::string_view{buffer, sz * nmemb}))
+            std::size_t size = sz * nmemb;
+
+            if(!this_->on_rx(std::string_view{buffer, size}))
                 return curl_base::default_write_abort;
 
-            std::size_t size = sz * nmemb;
+            switch(this_->response_headers.append(buffer, size)){
+                case header_block_t::line_t::status:
+                    this_->code = this_->response_headers.back().code();
 
-            if(!std::strncmp(buffer, "HTTP/", 5)){
-                if(!this_->get_status_code(std::string_view{buffer, size}))
-                    return curl_base::default_write_abort;
-            }
+                    if((bool)this_->code && !this_->on_status(this_->code))
+                        return curl_base::default_write_abort;
 
-            else if(size == 2 && !std::strncmp(buffer, "\r\n", 2)){
-                size = this_->string_writer(this_->response_buffer, buffer, sz, nmemb);
+                    break;
 
-                this_->response_headers.push_back(this_->response_buffer);
-                this_->response_buffer.clear();
+                case header_block_t::line_t::end:
+                    if constexpr(detail::is_decoding_writer<Writer>::value){
+                        if(this_->accept_encoding == accept_encoding_t::writer)
+                            this_->get_writer().content_encoding(this_->response_headers.back().get(header_names::content_encoding).value_or(std::string_view{}));
+                    }
 
-                if(this_->response_callback){
-                    std::stringstream stream{this_->response_headers.back()};
-                    response_t response;
-                    stream >> response;
+                    if constexpr(detail::has_expect<RX>::value || detail::has_writer_expect<Writer, RX>::value)
+                        this_->expect_body_size(this_->response_headers.back());
 
-                    if(!this_->response_callback(response))
+                    if(!this_->on_response(this_->response_headers.back()))
                         return curl_base::default_write_abort;
-                }
 
-                return size;
+                    break;
+
+                default:
+                    break;
             }
 
-            return this_->string_writer(this_->response_buffer, buffer, sz, nmemb);
+            return size;
         }
 
         catch(...){
@@ -174,14 +382,14 @@ namespace curlhttp{
 
     /*** GET REQUEST ***/
 
-    template<typename RX, typename Writer>
-    class http_request<method_t::get, RX, nullbuf_t, Writer>
-        : public http_request<method_t::none, RX, nullbuf_t, Writer>{
+    template<typename RX, typename Writer, typename Hooks>
+    class http_request<method_t::get, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>
+        : public http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>{
     public:
         query_t query;
 
         http_request(RX& buffer, const url_t& url)
-            : http_request<method_t::none, RX, nullbuf_t, Writer>{buffer, nullbuf, url} {}
+            : http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>{buffer, nullbuf, url} {}
 
         http_request(http_request&& ) = default;
         http_request& operator= (http_request&& ) = default;
@@ -190,12 +398,12 @@ namespace curlhttp{
 
         void init() override{
             setup_query();
-            http_request<method_t::none, RX, nullbuf_t, Writer>::init();
+            http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>::init();
             curl_base::set_option(CURLOPT_HTTPGET, true);
         }
 
         void reset() override{
-            http_request<method_t::none, RX, nullbuf_t, Writer>::reset();
+            http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>::reset();
             query.clear();
         }
 
@@ -214,14 +422,14 @@ namespace curlhttp{
 
     /*** OPTIONS REQUEST ***/
 
-    template<typename RX, typename Writer>
-    class http_request<method_t::options, RX, nullbuf_t, Writer>
-        : public http_request<method_t::none, RX, nullbuf_t, Writer>{
+    template<typename RX, typename Writer, typename Hooks>
+    class http_request<method_t::options, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>
+        : public http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>{
     public:
         std::string target{"*"};
 
         http_request(RX& buffer, const url_t& url)
-            : http_request<method_t::none, RX, nullbuf_t, Writer>{buffer, nullbuf, url} {}
+            : http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>{buffer, nullbuf, url} {}
 
         http_request(http_request&& ) = default;
         http_request& operator= (http_request&& ) = default;
@@ -229,13 +437,13 @@ namespace curlhttp{
         virtual ~http_request() {}
 
         void init() override{
-            http_request<method_t::none, RX, nullbuf_t, Writer>::init();
+            http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>::init();
             curl_base::set_option(CURLOPT_CUSTOMREQUEST, "OPTIONS");
             curl_base::set_option(CURLOPT_REQUEST_TARGET, target.c_str());
         }
 
         void reset() override{
-            http_request<method_t::none, RX, nullbuf_t, Writer>::reset();
+            http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>::reset();
             target.clear();
         }
     };
@@ -284,14 +492,15 @@ namespace curlhttp{
 
     /*** POST REQUEST ***/
 
-    template<typename RX, typename Writer>
-    class http_request<method_t::post, RX, nullbuf_t, Writer>
-        : public http_request<method_t::none, RX, nullbuf_t, Writer>{
+    template<typename RX, typename Writer, typename Hooks>
+    class http_request<method_t::post, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>
+        : public http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>{
     public:
         std::vector<field_t> data;
+        std::string body;
 
         http_request(RX& buffer, const url_t& url)
-            : http_request<method_t::none, RX, nullbuf_t, Writer>{buffer, nullbuf, url} {}
+            : http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>{buffer, nullbuf, url} {}
 
         http_request(http_request&& ) = default;
         http_request& operator= (http_request&& ) = default;
@@ -299,21 +508,25 @@ namespace curlhttp{
         virtual ~http_request() {}
 
         void init() override{
-            http_request<method_t::none, RX, nullbuf_t, Writer>::init();
+            http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>::init();
             setup_post_fields();
         }
 
         void reset() override{
-            http_request<method_t::none, RX, nullbuf_t, Writer>::reset();
+            http_request<method_t::none, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>::reset();
             data.clear();
+            body.clear();
+            encoded.clear();
         }
 
     private:
+        std::string encoded;
+
         void setup_post_fields(){
-            std::string s = query_string(data);
+            const std::string& s = data.empty() ? body : form_encode(encoded, data);
 
-            curl_base::set_option(CURLOPT_POSTFIELDSIZE_LARGE, s.size());
-            curl_base::set_option(CURLOPT_COPYPOSTFIELDS, s.c_str());
+            curl_base::set_option(CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)s.size());
+            curl_base::set_option(CURLOPT_POSTFIELDS, s.c_str());
         }
     };
 
@@ -321,20 +534,20 @@ namespace curlhttp{
 
     /*** SPECIAL POST REQUEST ***/
 
-    template<typename RX, typename TX, typename Writer, typename Reader, typename Seeker>
-    class http_request<method_t::special_post, RX, TX, Writer, Reader, Seeker>
-        : public http_request<method_t::none, RX, TX, Writer, Reader, Seeker>{
+    template<typename RX, typename TX, typename Writer, typename Reader, typename Seeker, typename Hooks>
+    class http_request<method_t::special_post, RX, TX, Writer, Reader, Seeker, Hooks>
+        : public http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>{
     public:
         http_request(RX& rx, TX& tx, const url_t& url)
-            : http_request<method_t::none, RX, TX, Writer, Reader, Seeker>{rx, tx, url} {}
+            : http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>{rx, tx, url} {}
 
         virtual ~http_request() {}
 
         void init() override{
-            http_request<method_t::none, RX, TX, Writer, Reader, Seeker>::init();
+            http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>::init();
 
             curl_base::set_option(CURLOPT_UPLOAD, true);
-            curl_base::set_option(CURLOPT_INFILESIZE_LARGE, size_getter<TX>{}(this->tx_buffer));
+            curl_base::set_option(CURLOPT_INFILESIZE_LARGE, upload_size(size_getter<TX>{}(this->tx_buffer)));
             curl_base::set_option(CURLOPT_CUSTOMREQUEST, "POST");
         }
     };
@@ -343,20 +556,20 @@ namespace curlhttp{
 
     /*** PUT REQUEST ***/
 
-    template<typename RX, typename TX, typename Writer, typename Reader, typename Seeker>
-    class http_request<method_t::put, RX, TX, Writer, Reader, Seeker>
-        : public http_request<method_t::none, RX, TX, Writer, Reader, Seeker>{
+    template<typename RX, typename TX, typename Writer, typename Reader, typename Seeker, typename Hooks>
+    class http_request<method_t::put, RX, TX, Writer, Reader, Seeker, Hooks>
+        : public http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>{
     public:
         http_request(RX& rx, TX& tx, const url_t& url)
-            : http_request<method_t::none, RX, TX, Writer, Reader, Seeker>{rx, tx, url} {}
+            : http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>{rx, tx, url} {}
 
         virtual ~http_request() {}
 
         void init() override{
-            http_request<method_t::none, RX, TX, Writer, Reader, Seeker>::init();
+            http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>::init();
 
             curl_base::set_option(CURLOPT_UPLOAD, true);
-            curl_base::set_option(CURLOPT_INFILESIZE_LARGE, size_getter<TX>{}(this->tx_buffer));
+            curl_base::set_option(CURLOPT_INFILESIZE_LARGE, upload_size(size_getter<TX>{}(this->tx_buffer)));
             curl_base::set_option(CURLOPT_CUSTOMREQUEST, "PUT");
         }
     };
@@ -365,20 +578,20 @@ namespace curlhttp{
 
     /*** DELETE REQUEST ***/
 
-    template<typename RX, typename TX, typename Writer, typename Reader, typename Seeker>
-    class http_request<method_t::delete_, RX, TX, Writer, Reader, Seeker>
-        : public http_request<method_t::none, RX, TX, Writer, Reader, Seeker>{
+    template<typename RX, typename TX, typename Writer, typename Reader, typename Seeker, typename Hooks>
+    class http_request<method_t::delete_, RX, TX, Writer, Reader, Seeker, Hooks>
+        : public http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>{
     public:
         http_request(RX& rx, TX& tx, const url_t& url)
-            : http_request<method_t::none, RX, TX, Writer, Reader, Seeker>{rx, tx, url} {}
+            : http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>{rx, tx, url} {}
 
         virtual ~http_request() {}
 
         void init() override{
-            http_request<method_t::none, RX, TX, Writer, Reader, Seeker>::init();
+            http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>::init();
 
             curl_base::set_option(CURLOPT_UPLOAD, true);
-            curl_base::set_option(CURLOPT_INFILESIZE_LARGE, size_getter<TX>{}(this->tx_buffer));
+            curl_base::set_option(CURLOPT_INFILESIZE_LARGE, upload_size(size_getter<TX>{}(this->tx_buffer)));
             curl_base::set_option(CURLOPT_CUSTOMREQUEST, "DELETE");
         }
     };
@@ -387,20 +600,20 @@ namespace curlhttp{
 
     /*** PATCH REQUEST ***/
 
-    template<typename RX, typename TX, typename Writer, typename Reader, typename Seeker>
-    class http_request<method_t::patch, RX, TX, Writer, Reader, Seeker>
-        : public http_request<method_t::none, RX, TX, Writer, Reader, Seeker>{
+    template<typename RX, typename TX, typename Writer, typename Reader, typename Seeker, typename Hooks>
+    class http_request<method_t::patch, RX, TX, Writer, Reader, Seeker, Hooks>
+        : public http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>{
     public:
         http_request(RX& rx, TX& tx, const url_t& url)
-            : http_request<method_t::none, RX, TX, Writer, Reader, Seeker>{rx, tx, url} {}
+            : http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>{rx, tx, url} {}
 
         virtual ~http_request() {}
 
         void init() override{
-            http_request<method_t::none, RX, TX, Writer, Reader, Seeker>::init();
+            http_request<method_t::none, RX, TX, Writer, Reader, Seeker, Hooks>::init();
 
             curl_base::set_option(CURLOPT_UPLOAD, true);
-            curl_base::set_option(CURLOPT_INFILESIZE_LARGE, size_getter<TX>{}(this->tx_buffer));
+            curl_base::set_option(CURLOPT_INFILESIZE_LARGE, upload_size(size_getter<TX>{}(this->tx_buffer)));
             curl_base::set_option(CURLOPT_CUSTOMREQUEST, "PATCH");
         }
     };
@@ -412,29 +625,34 @@ namespace curlhttp{
     using head_request = http_request<method_t::head, nullbuf_t, nullbuf_t>;
     using trace_request = http_request<method_t::trace, nullbuf_t, nullbuf_t>;
 
-    template<typename RX, typename Writer = default_writer<RX>>
-    using get_request = http_request<method_t::get, RX, nullbuf_t, Writer>;
+    template<typename RX, typename Writer = default_writer<RX>, typename Hooks = function_hooks>
+    using get_request = http_request<method_t::get, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>;
 
-    template<typename RX, typename Writer = default_writer<RX>>
-    using options_request = http_request<method_t::options, RX, nullbuf_t, Writer>;
+    template<typename RX, typename Writer = default_writer<RX>, typename Hooks = function_hooks>
+    using options_request = http_request<method_t::options, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>;
 
-    template<typename RX, typename Writer = default_writer<RX>>
-    using post_request = http_request<method_t::post, RX, nullbuf_t, Writer>;
+    template<typename RX, typename Writer = default_writer<RX>, typename Hooks = function_hooks>
+    using post_request = http_request<method_t::post, RX, nullbuf_t, Writer, default_reader<nullbuf_t>, default_seeker<nullbuf_t>, Hooks>;
 
-    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>>
-    using put_request = http_request<method_t::put, RX, TX, Writer, Reader, Seeker>;
+    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>,
+             typename Hooks = function_hooks>
+    using put_request = http_request<method_t::put, RX, TX, Writer, Reader, Seeker, Hooks>;
 
-    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>>
-    using special_post = http_request<method_t::special_post, RX, TX, Writer, Reader, Seeker>;
+    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>,
+             typename Hooks = function_hooks>
+    using special_post = http_request<method_t::special_post, RX, TX, Writer, Reader, Seeker, Hooks>;
 
-    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>>
-    using delete_request = http_request<method_t::delete_, RX, TX, Writer, Reader, Seeker>;
+    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>,
+             typename Hooks = function_hooks>
+    using delete_request = http_request<method_t::delete_, RX, TX, Writer, Reader, Seeker, Hooks>;
 
-    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>>
-    using patch_request = http_request<method_t::patch, RX, TX, Writer, Reader, Seeker>;
+    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>,
+             typename Hooks = function_hooks>
+    using patch_request = http_request<method_t::patch, RX, TX, Writer, Reader, Seeker, Hooks>;
 
-    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>>
-    using special_post_request = http_request<method_t::special_post, RX, TX, Writer, Reader, Seeker>;
+    template<typename RX, typename TX, typename Writer = default_writer<RX>, typename Reader = default_reader<TX>, typename Seeker = default_seeker<TX>,
+             typename Hooks = function_hooks>
+    using special_post_request = http_request<method_t::special_post, RX, TX, Writer, Reader, Seeker, Hooks>;
 
 
 
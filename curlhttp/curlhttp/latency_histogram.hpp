@@ -0,0 +1,277 @@
+#ifndef CURLHTTP_LATENCY_HISTOGRAM_HPP
+#define CURLHTTP_LATENCY_HISTOGRAM_HPP
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "transfer_info_t.hpp"
+
+
+namespace curlhttp{
+
+    struct histogram_snapshot_t{
+        std::vector<std::uint64_t> counts;
+        std::uint64_t count{}, sum{}, max{};
+
+        double mean() const{
+            return count ? (double)sum / (double)count : 0.0;
+        }
+
+        std::uint64_t percentile(double q) const;
+    };
+
+
+    class latency_histogram{
+    public:
+        static constexpr unsigned sub_bucket_bits = 4;
+        static constexpr std::uint64_t sub_buckets = 1 << sub_bucket_bits;
+        static constexpr unsigned max_exponent = 40;
+        static constexpr std::size_t bucket_count = (max_exponent - sub_bucket_bits + 2) * sub_buckets;
+        static constexpr std::uint64_t max_value = (std::uint64_t{1} << (max_exponent + 1)) - 1;
+
+        latency_histogram() = default;
+
+        latency_histogram(const latency_histogram& ) = delete;
+        latency_histogram& operator= (const latency_histogram& ) = delete;
+
+        void record(std::uint64_t value){
+            value = value > max_value ? max_value : value;
+
+            buckets[index(value)].fetch_add(1, std::memory_order_relaxed);
+            total.fetch_add(1, std::memory_order_relaxed);
+            sum.fetch_add(value, std::memory_order_relaxed);
+
+            std::uint64_t current = max.load(std::memory_order_relaxed);
+
+            while(current < value && !max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+        }
+
+        histogram_snapshot_t snapshot() const{
+            histogram_snapshot_t result;
+            result.counts.resize(bucket_count);
+
+            for(std::size_t n{}; n < bucket_count; ++n)
+                result.counts[n] = buckets[n].load(std::memory_order_relaxed);
+
+            result.count = total.load(std::memory_order_relaxed);
+            result.sum = sum.load(std::memory_order_relaxed);
+            result.max = max.load(std::memory_order_relaxed);
+
+            return result;
+        }
+
+        void clear(){
+            for(auto& bucket : buckets)
+                bucket.store(0, std::memory_order_relaxed);
+
+            total.store(0, std::memory_order_relaxed);
+            sum.store(0, std::memory_order_relaxed);
+            max.store(0, std::memory_order_relaxed);
+        }
+
+        static std::size_t index(std::uint64_t value){
+            if(value < sub_buckets)
+                return (std::size_t)value;
+
+            unsigned exponent = log2(value);
+            return (exponent - sub_bucket_bits + 1) * sub_buckets + ((value >> (exponent - sub_bucket_bits)) & (sub_buckets - 1));
+        }
+
+        static std::uint64_t lower_bound(std::size_t idx){
+            if(idx < sub_buckets)
+                return idx;
+
+            unsigned exponent = (unsigned)(idx / sub_buckets) + sub_bucket_bits - 1;
+            return (sub_buckets + idx % sub_buckets) << (exponent - sub_bucket_bits);
+        }
+
+    private:
+        std::array<std::atomic<std::uint64_t>, bucket_count> buckets{};
+        std::atomic<std::uint64_t> total{}, sum{}, max{};
+
+        static unsigned log2(std::uint64_t value){
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - (unsigned)__builtin_clzll(value);
+#else
+            unsigned result{};
+
+            while(value >>= 1)
+                ++result;
+
+            return result;
+#endif
+        }
+    };
+
+
+    inline std::uint64_t histogram_snapshot_t::percentile(double q) const{
+        if(!count)
+            return 0;
+
+        auto rank = (std::uint64_t)(q * (double)count);
+        std::uint64_t seen{};
+
+        for(std::size_t n{}; n < counts.size(); ++n){
+            seen += counts[n];
+
+            if(seen > rank)
+                return std::min(latency_histogram::lower_bound(n + 1) - 1, max);
+        }
+
+        return max;
+    }
+
+
+    struct phase_snapshot_t{
+        histogram_snapshot_t dns, connect, tls, pretransfer, ttfb, total;
+        std::uint64_t requests{}, connected{}, reused{}, redirects{}, bytes_downloaded{}, bytes_uploaded{};
+    };
+
+
+    struct latency_snapshot_t{
+        std::map<std::string, phase_snapshot_t> hosts, methods;
+    };
+
+
+    class latency_stats{
+    public:
+        void record(const std::string& host, const std::string& method, const transfer_info_t& info){
+            hosts.get(host).record(info);
+            methods.get(method).record(info);
+        }
+
+        latency_snapshot_t snapshot() const{
+            latency_snapshot_t result;
+
+            hosts.for_each([&result](const std::string& key, const phase_stats_t& stats){
+                result.hosts[key] = stats.snapshot();
+            });
+
+            methods.for_each([&result](const std::string& key, const phase_stats_t& stats){
+                result.methods[key] = stats.snapshot();
+            });
+
+            return result;
+        }
+
+    private:
+        struct phase_stats_t{
+            latency_histogram dns, connect, tls, pretransfer, ttfb, total;
+            std::atomic<std::uint64_t> requests{}, connected{}, reused{}, redirects{}, bytes_downloaded{}, bytes_uploaded{};
+
+            void record(const transfer_info_t& info){
+                auto handshake_end = info.appconnect_time ? info.appconnect_time : info.connect_time;
+
+                dns.record((std::uint64_t)info.namelookup_time);
+                connect.record(delta(info.connect_time, info.namelookup_time));
+
+                if(info.appconnect_time)
+                    tls.record(delta(info.appconnect_time, info.connect_time));
+
+                pretransfer.record(delta(info.pretransfer_time, handshake_end));
+                ttfb.record(delta(info.starttransfer_time, info.pretransfer_time));
+                total.record((std::uint64_t)info.total_time);
+
+                requests.fetch_add(1, std::memory_order_relaxed);
+                connected.fetch_add(info.connected(), std::memory_order_relaxed);
+                reused.fetch_add(info.reused_connection(), std::memory_order_relaxed);
+                redirects.fetch_add((std::uint64_t)info.redirect_count, std::memory_order_relaxed);
+                bytes_downloaded.fetch_add((std::uint64_t)info.bytes_downloaded, std::memory_order_relaxed);
+                bytes_uploaded.fetch_add((std::uint64_t)info.bytes_uploaded, std::memory_order_relaxed);
+            }
+
+            phase_snapshot_t snapshot() const{
+                return {
+                    dns.snapshot(), connect.snapshot(), tls.snapshot(), pretransfer.snapshot(), ttfb.snapshot(), total.snapshot(),
+                    requests.load(std::memory_order_relaxed), connected.load(std::memory_order_relaxed), reused.load(std::memory_order_relaxed),
+                    redirects.load(std::memory_order_relaxed), bytes_downloaded.load(std::memory_order_relaxed),
+                    bytes_uploaded.load(std::memory_order_relaxed)
+                };
+            }
+
+            static std::uint64_t delta(curl_off_t end, curl_off_t begin){
+                return end > begin ? (std::uint64_t)(end - begin) : 0;
+            }
+        };
+
+        class stats_list{
+        public:
+            stats_list() = default;
+
+            stats_list(const stats_list& ) = delete;
+            stats_list& operator= (const stats_list& ) = delete;
+
+            ~stats_list(){
+                node_t* p = head.load(std::memory_order_acquire);
+
+                while(p){
+                    node_t* next = p->next;
+                    delete p;
+                    p = next;
+                }
+            }
+
+            phase_stats_t& get(const std::string& key){
+                std::size_t hash = std::hash<std::string>{}(key);
+                node_t* first = head.load(std::memory_order_acquire);
+
+                if(node_t* p = find(first, nullptr, key, hash))
+                    return p->stats;
+
+                auto node = std::make_unique<node_t>(key, hash);
+                node->next = first;
+
+                while(!head.compare_exchange_weak(node->next, node.get(), std::memory_order_release, std::memory_order_acquire)){
+                    if(node_t* p = find(node->next, first, key, hash))
+                        return p->stats;
+
+                    first = node->next;
+                }
+
+                return node.release()->stats;
+            }
+
+            template<typename Function>
+            void for_each(Function&& callback) const{
+                for(node_t* p = head.load(std::memory_order_acquire); p; p = p->next)
+                    callback(p->key, p->stats);
+            }
+
+        private:
+            struct node_t{
+                const std::string key;
+                const std::size_t hash;
+                phase_stats_t stats;
+                node_t* next{};
+
+                node_t(const std::string& k, std::size_t h)
+                    : key{k}, hash{h} {}
+            };
+
+            std::atomic<node_t*> head{};
+
+            static node_t* find(node_t* begin, node_t* end, const std::string& key, std::size_t hash){
+                for(node_t* p = begin; p != end; p = p->next){
+                    if(p->hash == hash && p->key == key)
+                        return p;
+                }
+
+                return nullptr;
+            }
+        };
+
+        stats_list hosts, methods;
+    };
+
+}
+
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef CURLHTTP_MAPPED_FILE_T_HPP
+#define CURLHTTP_MAPPED_FILE_T_HPP
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <Windows.h>
+#endif
+
+#include <curl/curl.h>
+
+#include "curl_error.hpp"
+#include "default_reader.hpp"
+#include "default_seeker.hpp"
+#include "size_getter.hpp"
+
+
+namespace curlhttp{
+
+    // The file must not be truncated while it is mapped: reading a page past the new end raises SIGBUS.
+    // Use file_t for sources that may change during the upload.
+    class mapped_file_t{
+    public:
+        std::size_t read{};
+
+        mapped_file_t() = default;
+
+        explicit mapped_file_t(const std::filesystem::path& path){
+            open(path);
+        }
+
+        mapped_file_t(mapped_file_t&& rhs) noexcept
+            : read{rhs.read}, view{rhs.view}, length{rhs.length}{
+            rhs.view = nullptr;
+            rhs.length = 0;
+            rhs.read = 0;
+        }
+
+        mapped_file_t& operator= (mapped_file_t&& rhs) noexcept{
+            if(this != &rhs){
+                close();
+
+                read = rhs.read;
+                view = rhs.view;
+                length = rhs.length;
+
+                rhs.view = nullptr;
+                rhs.length = 0;
+                rhs.read = 0;
+            }
+
+            return *this;
+        }
+
+        ~mapped_file_t(){
+            close();
+        }
+
+        void open(const std::filesystem::path& path){
+            close();
+
+#ifndef _WIN32
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st{};
+
+            if(fd < 0)
+                throw_error("Cannot open file");
+
+            if(fstat(fd, &st)){
+                ::close(fd);
+                throw_error("Cannot stat file");
+            }
+
+            length = (std::size_t)st.st_size;
+
+            if(length){
+                void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if(p == MAP_FAILED){
+                    ::close(fd);
+                    length = 0;
+                    throw_error("Cannot map file");
+                }
+
+                madvise(p, length, MADV_SEQUENTIAL);
+                view = (const char*)p;
+            }
+
+            ::close(fd);
+#else
+            HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            LARGE_INTEGER size{};
+
+            if(file == INVALID_HANDLE_VALUE)
+                throw_error("Cannot open file");
+
+            if(!GetFileSizeEx(file, &size)){
+                CloseHandle(file);
+                throw_error("Cannot stat file");
+            }
+
+            length = (std::size_t)size.QuadPart;
+
+            if(length){
+                HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+                if(mapping)
+                    view = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+                if(mapping)
+                    CloseHandle(mapping);
+
+                if(!view){
+                    CloseHandle(file);
+                    length = 0;
+                    throw_error("Cannot map file");
+                }
+            }
+
+            CloseHandle(file);
+#endif
+        }
+
+        void close(){
+            if(view){
+#ifndef _WIN32
+                munmap((void*)view, length);
+#else
+                UnmapViewOfFile(view);
+#endif
+            }
+
+            view = nullptr;
+            length = 0;
+            read = 0;
+        }
+
+        const char* data() const{
+            return view;
+        }
+
+        std::size_t size() const{
+            return length;
+        }
+
+        std::size_t pending() const{
+            return length - read;
+        }
+
+    private:
+        const char* view{};
+        std::size_t length{};
+
+        [[noreturn]] static void throw_error(const char* message){
+            throw curl_error{make_error_code(CURLE_READ_ERROR), message};
+        }
+    };
+
+
+    template<>
+    struct default_reader<mapped_file_t>{
+        std::size_t operator()(mapped_file_t& file, char* buffer, std::size_t size, std::size_t nmemb){
+            std::size_t nread = std::min(file.pending(), size * nmemb);
+            std::memcpy(buffer, file.data() + file.read, nread);
+            file.read += nread;
+            return nread;
+        }
+    };
+
+
+    template<>
+    struct default_seeker<mapped_file_t>{
+        int operator()(mapped_file_t& file, curl_off_t offset, int origin){
+            curl_off_t position;
+
+            switch(origin){
+                case SEEK_SET:
+                    position = offset;
+                    break;
+
+                case SEEK_CUR:
+                    position = (curl_off_t)file.read + offset;
+                    break;
+
+                case SEEK_END:
+                    position = (curl_off_t)file.size() + offset;
+                    break;
+
+                default:
+                    return CURL_SEEKFUNC_FAIL;
+            }
+
+            if(position < 0 || (std::size_t)position > file.size())
+                return CURL_SEEKFUNC_FAIL;
+
+            file.read = (std::size_t)position;
+            return CURL_SEEKFUNC_OK;
+        }
+    };
+
+
+    template<>
+    struct size_getter<mapped_file_t>{
+        std::size_t operator()(const mapped_file_t& file) const{
+            return file.size();
+        }
+    };
+
+}
+
+
+#endif
@@ -3,6 +3,7 @@
 
 
 #include <filesystem>
+#include <functional>
 
 #include "default_reader.hpp"
 #include "default_seeker.hpp"
@@ -36,6 +37,8 @@ namespace curlhttp{
 
 
     class basic_mime_data{
+        friend class mime_holder;
+
     public:
         std::string name;
         std::string type;
@@ -51,7 +54,7 @@ namespace curlhttp{
             curl_mime_encoder(part, encoder_string(encoder).c_str());
 
             if(sub){
-                sub->setup();
+                sub->setup(*owner);
                 curl_mime_subparts(part, sub->native());
             }
 
@@ -59,10 +62,27 @@ namespace curlhttp{
                 curl_mime_subparts(part, 0);
         }
 
+        virtual bool ready() const{
+            return !sub || sub->ready();
+        }
+
         virtual ~basic_mime_data() {}
 
     protected:
         curl_mimepart* part;
+        curl_base* owner{};
+        bool paused{};
+
+        bool suspend(){
+            paused = true;
+            return owner->suspend();
+        }
+
+        std::function<void()> wakeup() const{
+            return [w = owner->waker]{
+                w->notify();
+            };
+        }
     };
 
 
@@ -108,7 +128,17 @@ namespace curlhttp{
 
         void setup() override{
             basic_mime_data::setup();
-            curl_mime_data_cb(part, size_getter<TX>{}(tx_buffer), &mime_data::read_callback, &mime_data::seek_callback, 0, this);
+            curl_mime_data_cb(part, upload_size(size_getter<TX>{}(tx_buffer)), &mime_data::read_callback, &mime_data::seek_callback, 0, this);
+
+            if constexpr(detail::has_notifier<TX>::value)
+                tx_buffer.set_notifier(wakeup());
+        }
+
+        bool ready() const override{
+            if constexpr(detail::has_readable<TX>::value)
+                return !paused || tx_buffer.readable();
+            else
+                return true;
         }
 
     private:
@@ -117,7 +147,20 @@ namespace curlhttp{
 
         static std::size_t read_callback(char* buffer, std::size_t size, std::size_t nmemb, void* voidp){
             auto* this_ = (mime_data*)voidp;
-            return this_->reader(this_->tx_buffer, buffer, size, nmemb);
+            std::size_t nread = this_->reader(this_->tx_buffer, buffer, size, nmemb);
+
+            if constexpr(detail::has_readable<TX>::value){
+                while(nread == CURL_READFUNC_PAUSE){
+                    if(this_->suspend())
+                        return nread;
+
+                    nread = this_->reader(this_->tx_buffer, buffer, size, nmemb);
+                }
+
+                this_->paused = false;
+            }
+
+            return nread;
         }
 
         static int seek_callback(void* voidp, curl_off_t offset, int origin){
@@ -19,7 +19,8 @@ namespace curlhttp{
         mime_holder(mime_holder&& ) = default;
         mime_holder& operator= (mime_holder&& ) = default;
 
-        void setup();
+        void setup(curl_base& owner);
+        bool ready() const;
 
         curl_mime* native() const{
             return mime.get();
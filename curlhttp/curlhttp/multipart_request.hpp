@@ -2,6 +2,8 @@
 #define CURLHTTP_MULTIPART_REQUEST_HPP
 
 
+#include <algorithm>
+
 #include "http_request.hpp"
 #include "mime_data.hpp"
 #include "mime_holder.hpp"
@@ -20,9 +22,7 @@ namespace curlhttp{
         void init() override{
             post_request<RX, Writer>::init();
             curl_base::set_option(CURLOPT_MIMEPOST, mimes.native());
-
-            for(auto& mime : mimes.data)
-                mime->setup();
+            mimes.setup(*this);
         }
 
         std::shared_ptr<file_data> create_file_data(const std::filesystem::path& filepath){
@@ -38,14 +38,27 @@ namespace curlhttp{
             return p;
         }
 
+    protected:
+        bool ready() const override{
+            return post_request<RX, Writer>::ready() && mimes.ready();
+        }
+
     private:
         std::unique_ptr<curl_mime, detail::curl_mime_deleter> mime;
     };
 
 
-    void mime_holder::setup(){
-        for(auto& m : data)
+    inline void mime_holder::setup(curl_base& owner){
+        for(auto& m : data){
+            m->owner = &owner;
             m->setup();
+        }
+    }
+
+    inline bool mime_holder::ready() const{
+        return std::all_of(data.begin(), data.end(), [](const auto& m){
+            return m->ready();
+        });
     }
 
 }
@@ -0,0 +1,386 @@
+#ifndef CURLHTTP_MULTIPART_UPLOAD_HPP
+#define CURLHTTP_MULTIPART_UPLOAD_HPP
+
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "async_handle.hpp"
+#include "buffer_t.hpp"
+#include "file_t.hpp"
+#include "header_names.hpp"
+#include "http_request.hpp"
+#include "result_t.hpp"
+#include "utility.hpp"
+
+
+namespace curlhttp{
+
+    struct file_part_t{
+        const file_t* file{};
+        std::uint64_t offset{}, size{}, read{};
+    };
+
+
+    template<>
+    struct default_reader<file_part_t>{
+        std::size_t operator()(file_part_t& part, char* buffer, std::size_t size, std::size_t nmemb){
+            std::size_t nread = (std::size_t)std::min<std::uint64_t>(part.size - part.read, size * nmemb);
+
+            if(part.file->read_at(buffer, nread, part.offset + part.read) != nread)
+                return CURL_READFUNC_ABORT;
+
+            part.read += nread;
+            return nread;
+        }
+    };
+
+
+    template<>
+    struct default_seeker<file_part_t>{
+        int operator()(file_part_t& part, curl_off_t offset, int origin){
+            curl_off_t position;
+
+            switch(origin){
+                case SEEK_SET:
+                    position = offset;
+                    break;
+
+                case SEEK_CUR:
+                    position = (curl_off_t)part.read + offset;
+                    break;
+
+                case SEEK_END:
+                    position = (curl_off_t)part.size + offset;
+                    break;
+
+                default:
+                    return CURL_SEEKFUNC_FAIL;
+            }
+
+            if(position < 0 || (std::uint64_t)position > part.size)
+                return CURL_SEEKFUNC_FAIL;
+
+            part.read = (std::uint64_t)position;
+            return CURL_SEEKFUNC_OK;
+        }
+    };
+
+
+    template<>
+    struct size_getter<file_part_t>{
+        std::size_t operator()(const file_part_t& part) const{
+            return (std::size_t)part.size;
+        }
+    };
+
+
+    struct upload_part_t{
+        std::size_t number{};
+        std::uint64_t offset{}, size{};
+        std::string etag{};
+        std::size_t attempts{};
+        bool done{};
+    };
+
+
+    class multipart_upload{
+    public:
+        using part_request_t = put_request<std::string, file_part_t>;
+
+        static constexpr std::size_t max_parts = 10000;
+
+        url_t url;
+        std::filesystem::path path;
+        std::uint64_t part_size{8 << 20};
+        std::size_t concurrency{4};
+        std::size_t max_attempts{4};
+        std::vector<std::shared_ptr<basic_easy_option>> options;
+
+        multipart_upload(const url_t& uri, const std::filesystem::path& p)
+            : url{uri}, path{p} {}
+
+        void perform(){
+            file.open_read(path);
+            split();
+            etag.clear();
+            abort_result = {};
+            initiate();
+
+            try{
+                upload();
+
+                for(const auto& part : parts){
+                    if(!part.done)
+                        throw curl_error{make_error_code(CURLE_SEND_ERROR), "Multipart upload incomplete"};
+                }
+
+                complete();
+            }
+
+            catch(...){
+                abort();
+                throw;
+            }
+        }
+
+        const std::string& get_upload_id() const{
+            return upload_id;
+        }
+
+        const std::vector<upload_part_t>& get_parts() const{
+            return parts;
+        }
+
+        const std::string& get_response() const{
+            return response;
+        }
+
+        const std::string& get_etag() const{
+            return etag;
+        }
+
+        const result_t& get_abort_result() const{
+            return abort_result;
+        }
+
+    private:
+        struct slot_t{
+            file_part_t body;
+            std::string response;
+            std::unique_ptr<part_request_t> request;
+            std::size_t part{};
+        };
+
+        file_t file;
+        std::vector<upload_part_t> parts;
+        std::string upload_id, response, etag;
+        result_t abort_result;
+        std::size_t next{};
+        bool failed{};
+
+        void split(){
+            std::uint64_t size = file.size();
+            std::uint64_t chunk = std::max<std::uint64_t>({part_size, (size + max_parts - 1) / max_parts, 1});
+
+            parts.clear();
+
+            // An empty source is uploaded as a single zero-byte part.
+            if(!size){
+                parts.push_back({1, 0, 0});
+                return;
+            }
+
+            for(std::uint64_t offset{}; offset < size; offset += chunk)
+                parts.push_back({parts.size() + 1, offset, std::min(chunk, size - offset)});
+        }
+
+        template<typename T>
+        void prepare(T& request) const{
+            for(auto& opt : options)
+                request.set_option(opt);
+        }
+
+        url_t make_url(const std::string& query) const{
+            url_t result{url};
+            result.set(CURLUPART_QUERY, query, CURLU_APPENDQUERY);
+            return result;
+        }
+
+        void initiate(){
+            std::string body;
+            post_request<std::string> request{body, make_url("uploads")};
+
+            prepare(request);
+            request.perform();
+
+            upload_id = xml_value(body, "UploadId");
+
+            if(upload_id.empty())
+                throw curl_error{make_error_code(CURLE_WEIRD_SERVER_REPLY), "Missing UploadId"};
+        }
+
+        void upload(){
+            async_handle handle;
+            handle.set_throw_errors(false);
+
+            std::vector<std::unique_ptr<slot_t>> slots;
+            next = 0;
+            failed = false;
+
+            while(slots.size() < concurrency && next < parts.size()){
+                slots.push_back(std::make_unique<slot_t>());
+                auto& slot = *slots.back();
+
+                slot.request = std::make_unique<part_request_t>(slot.response, slot.body, url);
+                slot.part = next++;
+                prepare_part(slot);
+
+                handle.add(*slot.request, [this, &handle, &slot](part_request_t& ){
+                    finished(handle, slot);
+                });
+            }
+
+            handle.perform();
+        }
+
+        void prepare_part(slot_t& slot){
+            auto& part = parts[slot.part];
+            auto& request = *slot.request;
+
+            slot.body = {&file, part.offset, part.size};
+            slot.response.clear();
+
+            request.url = make_url("partNumber=" + std::to_string(part.number) + "&uploadId=" + escape(upload_id));
+            prepare(request);
+
+            request.throw_easy_errors = false;
+            request.throw_http_errors = false;
+            request.throw_callback_exceptions = false;
+
+            ++part.attempts;
+        }
+
+        void finished(async_handle& handle, slot_t& slot){
+            auto& part = parts[slot.part];
+            auto& request = *slot.request;
+            const auto& headers = request.get_response_headers();
+
+            if(request.result().ok() && headers.size()){
+                if(auto etag = headers.back().get(header_names::etag)){
+                    part.etag = *etag;
+                    part.done = true;
+                }
+            }
+
+            if(!part.done && !failed && part.attempts < max_attempts){
+                prepare_part(slot);
+                handle.reuse(request);
+                return;
+            }
+
+            failed = failed || !part.done;
+
+            if(!failed && next < parts.size()){
+                slot.part = next++;
+                prepare_part(slot);
+                handle.reuse(request);
+            }
+        }
+
+        void complete(){
+            std::string xml{"<CompleteMultipartUpload>"};
+
+            for(const auto& part : parts)
+                xml += "<Part><PartNumber>" + std::to_string(part.number) + "</PartNumber><ETag>" + xml_escape(part.etag) + "</ETag></Part>";
+
+            xml += "</CompleteMultipartUpload>";
+
+            buffer_t<std::string> body{xml};
+            special_post_request<std::string, buffer_t<std::string>> request{response, body, make_url("uploadId=" + escape(upload_id))};
+
+            response.clear();
+            prepare(request);
+            request.headers = {{"Content-Type", "application/xml"}};
+            request.perform();
+
+            if(response.find("<CompleteMultipartUploadResult") == std::string::npos || (etag = xml_value(response, "ETag")).empty())
+                throw curl_error{make_error_code(CURLE_HTTP_RETURNED_ERROR), "Multipart upload completion failed"};
+        }
+
+        void abort(){
+            if(upload_id.empty())
+                return;
+
+            try{
+                std::string body;
+                delete_request<std::string, nullbuf_t> request{body, nullbuf, make_url("uploadId=" + escape(upload_id))};
+
+                prepare(request);
+                request.throw_easy_errors = false;
+                request.throw_http_errors = false;
+                request.perform();
+
+                abort_result = request.result();
+            }
+
+            catch(const std::system_error& e){
+                abort_result = {e.code()};
+            }
+        }
+
+        static std::string xml_value(std::string_view xml, std::string_view tag){
+            std::string open = '<' + std::string{tag} + '>';
+            std::string close = "</" + std::string{tag} + '>';
+
+            std::size_t begin = xml.find(open);
+
+            if(begin == xml.npos)
+                return {};
+
+            begin += open.size();
+            std::size_t end = xml.find(close, begin);
+
+            if(end == xml.npos)
+                return {};
+
+            return xml_unescape(xml.substr(begin, end - begin));
+        }
+
+        static std::string xml_escape(std::string_view s){
+            std::string result;
+            result.reserve(s.size());
+
+            for(char c : s){
+                switch(c){
+                    case '&': result += "&amp;"; break;
+                    case '<': result += "&lt;"; break;
+                    case '>': result += "&gt;"; break;
+                    case '"': result += "&quot;"; break;
+                    case '\'': result += "&apos;"; break;
+                    default: result += c;
+                }
+            }
+
+            return result;
+        }
+
+        static std::string xml_unescape(std::string_view s){
+            static constexpr std::string_view entities[][2] = {
+                {"&amp;", "&"}, {"&lt;", "<"}, {"&gt;", ">"}, {"&quot;", "\""}, {"&apos;", "'"}
+            };
+
+            std::string result;
+            result.reserve(s.size());
+
+            for(std::size_t n{}; n < s.size();){
+                bool replaced{};
+
+                if(s[n] == '&'){
+                    for(const auto& entity : entities){
+                        if(s.substr(n, entity[0].size()) == entity[0]){
+                            result += entity[1];
+                            n += entity[0].size();
+                            replaced = true;
+                            break;
+                        }
+                    }
+                }
+
+                if(!replaced)
+                    result += s[n++];
+            }
+
+            return result;
+        }
+    };
+
+}
+
+
+#endif
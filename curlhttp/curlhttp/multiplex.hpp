@@ -0,0 +1,94 @@
+#ifndef CURLHTTP_MULTIPLEX_HPP
+#define CURLHTTP_MULTIPLEX_HPP
+
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+#include <curl/curl.h>
+
+#include "transfer_info_t.hpp"
+
+
+namespace curlhttp{
+
+    struct multiplex_t{
+        long http_version{CURL_HTTP_VERSION_2TLS};
+        long max_concurrent_streams{100};
+        long max_host_connections{};
+        long max_total_connections{};
+        bool pipewait{true};
+    };
+
+
+    class connection_stats{
+    public:
+        struct connection_t{
+            std::uint64_t completed{};
+            long http_version{};
+        };
+
+        struct summary_t{
+            std::size_t connections{}, http2_connections{};
+            std::uint64_t completed{}, max_completed_per_connection{};
+
+            double completed_per_connection() const{
+                return connections ? (double)completed / (double)connections : 0.0;
+            }
+        };
+
+        // Beyond max_connections the lowest id is evicted, which is the oldest connection when CURLINFO_CONN_ID is available.
+        explicit connection_stats(std::size_t max_connections = 1024) : limit{std::max<std::size_t>(max_connections, 1)} {}
+
+        void record(const transfer_info_t& info){
+            if(info.connection_id < 0)
+                return;
+
+            std::lock_guard<std::mutex> lock{mutex};
+            auto& connection = connections[info.connection_id];
+
+            ++connection.completed;
+            connection.http_version = info.http_version;
+
+            if(connections.size() > limit)
+                connections.erase(connections.begin());
+        }
+
+        std::map<curl_off_t, connection_t> snapshot() const{
+            std::lock_guard<std::mutex> lock{mutex};
+            return connections;
+        }
+
+        summary_t summary() const{
+            std::lock_guard<std::mutex> lock{mutex};
+            summary_t result;
+
+            for(const auto& item : connections){
+                ++result.connections;
+                result.completed += item.second.completed;
+                result.max_completed_per_connection = std::max(result.max_completed_per_connection, item.second.completed);
+
+                if(item.second.http_version >= CURL_HTTP_VERSION_2_0)
+                    ++result.http2_connections;
+            }
+
+            return result;
+        }
+
+        void clear(){
+            std::lock_guard<std::mutex> lock{mutex};
+            connections.clear();
+        }
+
+    private:
+        mutable std::mutex mutex;
+        std::map<curl_off_t, connection_t> connections;
+        std::size_t limit;
+    };
+
+}
+
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef CURLHTTP_NOTIFIER_T_HPP
+#define CURLHTTP_NOTIFIER_T_HPP
+
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <curl/curl.h>
+
+
+namespace curlhttp{
+
+    class notifier_t{
+    public:
+        void set(std::function<void()> fn){
+            std::lock_guard<std::mutex> lock{mutex};
+            callback = std::move(fn);
+        }
+
+        void operator()() const{
+            std::lock_guard<std::mutex> lock{mutex};
+
+            if(callback)
+                callback();
+        }
+
+    private:
+        mutable std::mutex mutex;
+        std::function<void()> callback;
+    };
+
+
+    namespace detail{
+
+        class waker_t{
+        public:
+            void attach(std::weak_ptr<CURLM> handle){
+                std::lock_guard<std::mutex> lock{mutex};
+                multi = std::move(handle);
+            }
+
+            void notify(){
+                std::lock_guard<std::mutex> lock{mutex};
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+                if(auto handle = multi.lock())
+                    curl_multi_wakeup(handle.get());
+#endif
+
+                condition.notify_all();
+            }
+
+            template<typename Predicate>
+            void wait(Predicate&& ready){
+                std::unique_lock<std::mutex> lock{mutex};
+                condition.wait(lock, std::forward<Predicate>(ready));
+            }
+
+        private:
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::weak_ptr<CURLM> multi;
+        };
+
+    }
+
+}
+
+
+#endif
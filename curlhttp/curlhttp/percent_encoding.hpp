@@ -0,0 +1,248 @@
+#ifndef CURLHTTP_PERCENT_ENCODING_HPP
+#define CURLHTTP_PERCENT_ENCODING_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CURLHTTP_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+
+namespace curlhttp{
+
+    enum class percent_mode_t : char{
+        url, form
+    };
+
+
+    constexpr bool is_unreserved(unsigned char c){
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '-' || c == '.' || c == '_' || c == '~';
+    }
+
+
+    constexpr bool is_form_safe(unsigned char c){
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '-' || c == '.' || c == '_' || c == '*';
+    }
+
+
+    namespace detail{
+
+        inline unsigned count_trailing_zeros(std::uint32_t mask){
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return (unsigned)index;
+#else
+            return (unsigned)__builtin_ctz(mask);
+#endif
+        }
+
+
+        inline int hex_value(unsigned char c){
+            if(c >= '0' && c <= '9')
+                return c - '0';
+
+            c |= 0x20;
+            return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+        }
+
+
+        inline char* encode_byte(char* out, unsigned char c, percent_mode_t mode){
+            static constexpr char hex[] = "0123456789ABCDEF";
+
+            if(mode == percent_mode_t::form ? is_form_safe(c) : is_unreserved(c))
+                *out++ = (char)c;
+
+            else if(mode == percent_mode_t::form && c == ' ')
+                *out++ = '+';
+
+            else{
+                *out++ = '%';
+                *out++ = hex[c >> 4];
+                *out++ = hex[c & 15];
+            }
+
+            return out;
+        }
+
+
+        inline std::size_t decode_token(char* out, const char* in, std::size_t size, percent_mode_t mode){
+            if(in[0] == '%' && size >= 3){
+                int high = hex_value((unsigned char)in[1]);
+                int low = hex_value((unsigned char)in[2]);
+
+                if(high >= 0 && low >= 0){
+                    *out = (char)(high << 4 | low);
+                    return 3;
+                }
+            }
+
+            *out = mode == percent_mode_t::form && in[0] == '+' ? ' ' : in[0];
+            return 1;
+        }
+
+
+#ifdef CURLHTTP_SSE2
+        inline std::uint32_t safe_mask(__m128i v, percent_mode_t mode){
+            __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+            __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+            __m128i mark = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')), _mm_cmpeq_epi8(v, _mm_set1_epi8('.'))),
+                                        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('_')), _mm_cmpeq_epi8(v, _mm_set1_epi8(mode == percent_mode_t::form ? '*' : '~'))));
+
+            return (std::uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), mark));
+        }
+
+        inline std::uint32_t escape_mask(__m128i v, percent_mode_t mode){
+            __m128i mask = _mm_cmpeq_epi8(v, _mm_set1_epi8('%'));
+
+            if(mode == percent_mode_t::form)
+                mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, _mm_set1_epi8('+')));
+
+            return (std::uint32_t)_mm_movemask_epi8(mask);
+        }
+#endif
+
+
+#if defined(__AVX2__)
+        inline std::uint32_t safe_mask(__m256i v, percent_mode_t mode){
+            __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+            __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+            __m256i mark = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('.'))),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(mode == percent_mode_t::form ? '*' : '~'))));
+
+            return (std::uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(alpha, digit), mark));
+        }
+
+        inline std::uint32_t escape_mask(__m256i v, percent_mode_t mode){
+            __m256i mask = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('%'));
+
+            if(mode == percent_mode_t::form)
+                mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('+')));
+
+            return (std::uint32_t)_mm256_movemask_epi8(mask);
+        }
+#endif
+
+    }
+
+
+    inline std::size_t percent_encode(char* out, const char* in, std::size_t size, percent_mode_t mode = percent_mode_t::url){
+        char* begin = out;
+        std::size_t n{};
+
+#if defined(__AVX2__)
+        while(n + 32 <= size){
+            __m256i v = _mm256_loadu_si256((const __m256i*)(in + n));
+            std::uint32_t mask = detail::safe_mask(v, mode);
+
+            _mm256_storeu_si256((__m256i*)out, v);
+
+            if(mask == 0xffffffffu){
+                out += 32;
+                n += 32;
+                continue;
+            }
+
+            unsigned safe = detail::count_trailing_zeros(~mask);
+            out = detail::encode_byte(out + safe, (unsigned char)in[n + safe], mode);
+            n += safe + 1;
+        }
+#endif
+
+#ifdef CURLHTTP_SSE2
+        while(n + 16 <= size){
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + n));
+            std::uint32_t mask = detail::safe_mask(v, mode);
+
+            _mm_storeu_si128((__m128i*)out, v);
+
+            if(mask == 0xffff){
+                out += 16;
+                n += 16;
+                continue;
+            }
+
+            unsigned safe = detail::count_trailing_zeros(~mask);
+            out = detail::encode_byte(out + safe, (unsigned char)in[n + safe], mode);
+            n += safe + 1;
+        }
+#endif
+
+        for(; n < size; ++n)
+            out = detail::encode_byte(out, (unsigned char)in[n], mode);
+
+        return (std::size_t)(out - begin);
+    }
+
+
+    inline std::size_t percent_decode(char* out, const char* in, std::size_t size, percent_mode_t mode = percent_mode_t::url){
+        char* begin = out;
+        std::size_t n{};
+
+#if defined(__AVX2__)
+        while(n + 32 <= size){
+            __m256i v = _mm256_loadu_si256((const __m256i*)(in + n));
+            std::uint32_t mask = detail::escape_mask(v, mode);
+
+            if(!mask){
+                _mm256_storeu_si256((__m256i*)out, v);
+                out += 32;
+                n += 32;
+                continue;
+            }
+
+            unsigned plain = detail::count_trailing_zeros(mask);
+
+            _mm256_storeu_si256((__m256i*)out, v);
+            out += plain;
+            n += plain;
+            n += detail::decode_token(out++, in + n, size - n, mode);
+        }
+#endif
+
+#ifdef CURLHTTP_SSE2
+        while(n + 16 <= size){
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + n));
+            std::uint32_t mask = detail::escape_mask(v, mode);
+
+            if(!mask){
+                _mm_storeu_si128((__m128i*)out, v);
+                out += 16;
+                n += 16;
+                continue;
+            }
+
+            unsigned plain = detail::count_trailing_zeros(mask);
+
+            _mm_storeu_si128((__m128i*)out, v);
+            out += plain;
+            n += plain;
+            n += detail::decode_token(out++, in + n, size - n, mode);
+        }
+#endif
+
+        while(n < size)
+            n += detail::decode_token(out++, in + n, size - n, mode);
+
+        return (std::size_t)(out - begin);
+    }
+
+}
+
+
+#endif
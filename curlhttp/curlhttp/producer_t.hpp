@@ -0,0 +1,130 @@
+#ifndef CURLHTTP_PRODUCER_T_HPP
+#define CURLHTTP_PRODUCER_T_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#include <curl/curl.h>
+
+#include "default_reader.hpp"
+#include "default_seeker.hpp"
+#include "notifier_t.hpp"
+#include "size_getter.hpp"
+#include "spsc_queue.hpp"
+
+
+namespace curlhttp{
+
+    class producer_t{
+    public:
+        explicit producer_t(std::size_t capacity = 64)
+            : queue{capacity} {}
+
+        bool push(std::string chunk){
+            if(chunk.empty())
+                return true;
+
+            if(!queue.try_push(std::move(chunk)))
+                return false;
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if(waiting.exchange(false, std::memory_order_relaxed))
+                notifier();
+
+            return true;
+        }
+
+        void close(){
+            finished.store(true, std::memory_order_release);
+            notifier();
+        }
+
+        void set_notifier(std::function<void()> fn){
+            notifier.set(std::move(fn));
+        }
+
+        bool closed() const{
+            return finished.load(std::memory_order_acquire);
+        }
+
+        bool readable() const{
+            return !queue.empty() || closed();
+        }
+
+        std::size_t read(char* buffer, std::size_t size){
+            std::size_t nread{};
+
+            while(nread < size){
+                if(offset == current.size()){
+                    current.clear();
+                    offset = 0;
+
+                    if(!queue.try_pop(current)){
+                        if(nread)
+                            break;
+
+                        if(!closed()){
+                            waiting.store(true, std::memory_order_relaxed);
+                            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                            if(queue.empty() && !closed())
+                                return CURL_READFUNC_PAUSE;
+
+                            continue;
+                        }
+
+                        if(!queue.try_pop(current))
+                            return 0;
+                    }
+                }
+
+                std::size_t n = std::min(size - nread, current.size() - offset);
+                std::memcpy(buffer + nread, current.data() + offset, n);
+
+                nread += n;
+                offset += n;
+            }
+
+            return nread;
+        }
+
+    private:
+        spsc_queue<std::string> queue;
+        std::string current;
+        std::size_t offset{};
+        std::atomic<bool> finished{}, waiting{};
+        notifier_t notifier;
+    };
+
+
+    template<>
+    struct default_reader<producer_t>{
+        std::size_t operator()(producer_t& producer, char* buffer, std::size_t size, std::size_t nmemb){
+            return producer.read(buffer, size * nmemb);
+        }
+    };
+
+
+    template<>
+    struct default_seeker<producer_t>{
+        int operator()(producer_t& , curl_off_t , int ){
+            return CURL_SEEKFUNC_CANTSEEK;
+        }
+    };
+
+
+    template<>
+    struct size_getter<producer_t>{
+        std::size_t operator()(const producer_t& ) const{
+            return unknown_size;
+        }
+    };
+
+}
+
+
+#endif
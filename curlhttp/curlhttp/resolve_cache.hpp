@@ -0,0 +1,286 @@
+#ifndef CURLHTTP_RESOLVE_CACHE_HPP
+#define CURLHTTP_RESOLVE_CACHE_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <map>
+#include <vector>
+
+#ifndef _WIN32
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <netdb.h>
+#else
+    #include <WinSock2.h>
+    #include <WS2tcpip.h>
+#endif
+
+#include <curl/curl.h>
+
+#include "detail.hpp"
+
+
+namespace curlhttp{
+
+    // getaddrinfo() reports no record TTL, so every entry is refreshed after the configured ttl.
+    class resolve_cache{
+    public:
+        using clock_type = std::chrono::steady_clock;
+
+        struct entry_t{
+            std::string host;
+            unsigned short port{};
+            std::vector<std::string> addresses;
+            clock_type::time_point expires;
+            bool refreshing{};
+        };
+
+        std::chrono::seconds ttl{60};
+
+        resolve_cache()
+            : state{std::make_shared<state_t>()} {}
+
+        ~resolve_cache(){
+            stop();
+        }
+
+        resolve_cache(resolve_cache&& ) = default;
+        resolve_cache& operator= (resolve_cache&& rhs) noexcept{
+            if(this != &rhs){
+                stop();
+
+                state = std::move(rhs.state);
+                worker = std::move(rhs.worker);
+                list = std::move(rhs.list);
+                previous = std::move(rhs.previous);
+                list_generation = rhs.list_generation;
+                ttl = rhs.ttl;
+            }
+
+            return *this;
+        }
+
+        void add(const std::string& host, unsigned short port){
+            {
+                std::lock_guard<std::mutex> lock{state->mutex};
+                auto& entry = state->entries[key(host, port)];
+
+                if(entry.host.size())
+                    return;
+
+                entry.host = host;
+                entry.port = port;
+                entry.refreshing = true;
+
+                state->removed.erase(key(host, port));
+                enqueue(host, port);
+            }
+        }
+
+        void remove(const std::string& host, unsigned short port){
+            std::lock_guard<std::mutex> lock{state->mutex};
+
+            if(state->entries.erase(key(host, port))){
+                state->removed.insert(key(host, port));
+                ++state->generation;
+            }
+        }
+
+        void insert(const entry_t& entry){
+            std::lock_guard<std::mutex> lock{state->mutex};
+            auto& e = state->entries[key(entry.host, entry.port)];
+
+            if(e.refreshing || e.addresses.size())
+                return;
+
+            e = entry;
+            e.refreshing = false;
+            state->removed.erase(key(entry.host, entry.port));
+            ++state->generation;
+        }
+
+        std::vector<entry_t> entries() const{
+            std::lock_guard<std::mutex> lock{state->mutex};
+            std::vector<entry_t> result;
+
+            for(const auto& item : state->entries)
+                result.push_back(item.second);
+
+            return result;
+        }
+
+        bool ready() const{
+            std::lock_guard<std::mutex> lock{state->mutex};
+
+            for(const auto& item : state->entries){
+                if(item.second.addresses.empty())
+                    return false;
+            }
+
+            return true;
+        }
+
+        curl_slist* resolve_list(){
+            auto now = clock_type::now();
+            std::lock_guard<std::mutex> lock{state->mutex};
+
+            for(auto& item : state->entries){
+                auto& entry = item.second;
+
+                if(!entry.refreshing && entry.expires <= now){
+                    entry.refreshing = true;
+                    enqueue(entry.host, entry.port);
+                }
+            }
+
+            if(list_generation != state->generation){
+                previous = std::move(list);
+
+                for(const auto& removed : state->removed)
+                    list.reset(curl_slist_append(list.release(), ('-' + removed).c_str()));
+
+                state->removed.clear();
+
+                for(const auto& item : state->entries){
+                    if(item.second.addresses.empty())
+                        continue;
+
+                    std::string line = item.first + ':';
+
+                    for(const auto& address : item.second.addresses)
+                        line += address + ',';
+
+                    line.pop_back();
+                    list.reset(curl_slist_append(list.release(), line.c_str()));
+                }
+
+                list_generation = state->generation;
+            }
+
+            return list.get();
+        }
+
+    private:
+        struct job_t{
+            std::string host;
+            unsigned short port{};
+            std::chrono::seconds ttl{};
+        };
+
+        struct state_t{
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::map<std::string, entry_t> entries;
+            std::set<std::string> removed;
+            std::deque<job_t> jobs;
+            std::size_t generation{};
+            bool stopped{};
+        };
+
+        std::shared_ptr<state_t> state;
+        std::thread worker;
+        std::unique_ptr<curl_slist, detail::curl_slist_deleter> list, previous;
+        std::size_t list_generation{};
+
+        void enqueue(const std::string& host, unsigned short port){
+            state->jobs.push_back({host, port, ttl});
+            state->condition.notify_one();
+
+            if(!worker.joinable())
+                worker = std::thread{&resolve_cache::run, state};
+        }
+
+        void stop(){
+            if(!worker.joinable())
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock{state->mutex};
+                state->stopped = true;
+            }
+
+            state->condition.notify_one();
+            worker.join();
+        }
+
+        static std::string key(const std::string& host, unsigned short port){
+            return host + ':' + std::to_string(port);
+        }
+
+        static std::vector<std::string> resolve(const std::string& host, unsigned short port){
+            addrinfo hints{};
+            addrinfo* info{};
+            std::vector<std::string> result;
+
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+
+            if(getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &info))
+                return result;
+
+            for(addrinfo* p = info; p; p = p->ai_next){
+                char buffer[INET6_ADDRSTRLEN];
+
+                if(p->ai_family == AF_INET && inet_ntop(AF_INET, &((sockaddr_in*)p->ai_addr)->sin_addr, buffer, sizeof(buffer)))
+                    result.push_back(buffer);
+
+                else if(p->ai_family == AF_INET6 && inet_ntop(AF_INET6, &((sockaddr_in6*)p->ai_addr)->sin6_addr, buffer, sizeof(buffer)))
+                    result.push_back(std::string{"["} + buffer + ']');
+            }
+
+            freeaddrinfo(info);
+            return result;
+        }
+
+        static void run(std::shared_ptr<state_t> state){
+            std::unique_lock<std::mutex> lock{state->mutex};
+
+            while(true){
+                state->condition.wait(lock, [&]{ return state->stopped || state->jobs.size(); });
+
+                if(state->stopped)
+                    return;
+
+                job_t job = std::move(state->jobs.front());
+                state->jobs.pop_front();
+
+                lock.unlock();
+                auto addresses = resolve(job.host, job.port);
+                lock.lock();
+
+                auto it = state->entries.find(key(job.host, job.port));
+
+                if(it == state->entries.end())
+                    continue;
+
+                it->second.refreshing = false;
+
+                if(addresses.empty()){
+                    it->second.expires = clock_type::now() + std::min(job.ttl, std::chrono::seconds{5});
+                    continue;
+                }
+
+                if(addresses != it->second.addresses){
+                    it->second.addresses = std::move(addresses);
+                    ++state->generation;
+                }
+
+                it->second.expires = clock_type::now() + job.ttl;
+            }
+        }
+    };
+
+}
+
+
+#endif
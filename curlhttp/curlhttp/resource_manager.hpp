@@ -2,7 +2,11 @@
 #define CURLHTTP_RESOURCE_MANAGER_HPP
 
 
+#include <ctime>
+
 #include "http_manager.hpp"
+#include "resolve_cache.hpp"
+#include "share_snapshot.hpp"
 #include "utility.hpp"
 
 
@@ -10,26 +14,75 @@ namespace curlhttp{
 
     class resource_manager : public http_manager{
     public:
+        resolve_cache resolver;
+        std::filesystem::path snapshot_path;
+        std::chrono::seconds snapshot_interval{};
+
         explicit resource_manager(const url_t& endp)
-            : endpoint{endp}, share{curl_share_init()} {}
+            : endpoint{endp}, share{curl_share_init()}{
+
+            setup_share();
+        }
 
         resource_manager(resource_manager&& ) = default;
         resource_manager& operator= (resource_manager&& ) = default;
 
-        virtual ~resource_manager() {}
+        virtual ~resource_manager(){
+            if(share && !snapshot_path.empty()){
+                try{
+                    save_snapshot(snapshot_path);
+                }
+
+                catch(...) {}
+            }
+        }
 
         void init() override{
-            setup_share();
+            resolve_list = resolver.resolve_list();
+            http_manager::init();
+        }
 
-            for(auto& item : requests){
-                item.second.request->init();
-                item.second.request->set_option(CURLOPT_SHARE, share.get());
-            }
+        void init(curl_base& request) override{
+            http_manager::init(request);
+            request.set_option(CURLOPT_SHARE, share.get());
+            request.set_option(CURLOPT_RESOLVE, resolve_list);
+        }
+
+        void pre_resolve(const std::string& host, unsigned short port){
+            resolver.add(host, port);
+        }
+
+        void pre_resolve(){
+            auto host = endpoint.get(CURLUPART_HOST);
+            auto port = endpoint.get(CURLUPART_PORT, CURLU_DEFAULT_PORT);
+
+            if(host && port)
+                resolver.add(*host, (unsigned short)std::stoul(*port));
+        }
+
+        void perform() override{
+            http_manager::perform();
+
+            if(!snapshot_path.empty() && snapshot_interval.count()
+                    && std::chrono::steady_clock::now() - last_snapshot >= snapshot_interval)
+                save_snapshot(snapshot_path);
         }
 
         void remove(curl_base& request) override{
             http_manager::remove(request);
             request.set_option(CURLOPT_SHARE, 0);
+            request.set_option(CURLOPT_RESOLVE, (curl_slist*)nullptr);
+        }
+
+        using http_manager::prewarm;
+
+        std::size_t prewarm(std::size_t n){
+            return http_manager::prewarm("", n);
+        }
+
+        template<typename Function>
+        std::size_t prewarm(std::size_t n, Function&& callback){
+            return http_manager::prewarm("", n, std::forward<Function>(callback));
         }
 
         url_t generate_url(const std::string& rel) const{
@@ -60,6 +113,65 @@ namespace curlhttp{
             return share.get();
         }
 
+        share_snapshot_t snapshot(){
+            share_snapshot_t result;
+            auto easy = share_handle();
+            curl_slist* cookies{};
+
+            result.dns = resolver.entries();
+
+            if(curl_easy_getinfo(easy.get(), CURLINFO_COOKIELIST, &cookies) == CURLE_OK){
+                for(curl_slist* p = cookies; p; p = p->next)
+                    result.cookies.push_back(p->data);
+
+                curl_slist_free_all(cookies);
+            }
+
+#if LIBCURL_VERSION_NUM >= 0x080c00
+            curl_easy_ssls_export(easy.get(), &resource_manager::export_ssl_session, &result);
+#endif
+
+            return result;
+        }
+
+        void restore(const share_snapshot_t& snap){
+            auto easy = share_handle();
+
+            for(const auto& entry : snap.dns)
+                resolver.insert(entry);
+
+            for(const auto& cookie : snap.cookies)
+                curl_easy_setopt(easy.get(), CURLOPT_COOKIELIST, cookie.c_str());
+
+#if LIBCURL_VERSION_NUM >= 0x080c00
+            auto now = (std::int64_t)std::time(nullptr);
+
+            for(const auto& session : snap.ssl_sessions){
+                if(session.valid_until && session.valid_until <= now)
+                    continue;
+
+                curl_easy_ssls_import(easy.get(), session.key.c_str(),
+                                      (const unsigned char*)session.hmac.data(), session.hmac.size(),
+                                      (const unsigned char*)session.data.data(), session.data.size());
+            }
+#endif
+        }
+
+        void save_snapshot(const std::filesystem::path& path){
+            snapshot().save(path);
+            last_snapshot = std::chrono::steady_clock::now();
+        }
+
+        bool load_snapshot(const std::filesystem::path& path){
+            share_snapshot_t snap;
+
+            if(!snap.load(path))
+                return false;
+
+            restore(snap);
+            return true;
+        }
+
     protected:
         url_t make_url(const std::string& rel) const override{
             return generate_url(rel);
@@ -68,6 +180,24 @@ namespace curlhttp{
     private:
         url_t endpoint;
         std::unique_ptr<CURLSH, detail::CURLSH_deleter> share;
+        std::chrono::steady_clock::time_point last_snapshot{std::chrono::steady_clock::now()};
+        curl_slist* resolve_list{};
+
+        std::unique_ptr<CURL, detail::CURL_deleter> share_handle() const{
+            std::unique_ptr<CURL, detail::CURL_deleter> easy{curl_easy_init()};
+            curl_easy_setopt(easy.get(), CURLOPT_SHARE, share.get());
+            return easy;
+        }
+
+#if LIBCURL_VERSION_NUM >= 0x080c00
+        static CURLcode export_ssl_session(CURL* , void* userp, const char* key, const unsigned char* hmac, std::size_t hmac_size,
+                                           const unsigned char* data, std::size_t data_size, curl_off_t valid_until, int , const char* , std::size_t ){
+
+            auto* snap = (share_snapshot_t*)userp;
+            snap->ssl_sessions.push_back({key, std::string{(const char*)hmac, hmac_size}, std::string{(const char*)data, data_size}, valid_until});
+            return CURLE_OK;
+        }
+#endif
 
         template<typename Function, typename... Args>
         void share_error_checker(Function&& callback, Args&&... arguments){
@@ -2,6 +2,7 @@
 #define CURLHTTP_RESPONSE_T_HPP
 
 
+#include <istream>
 #include <string>
 #include <vector>
 
@@ -0,0 +1,44 @@
+#ifndef CURLHTTP_RESULT_T_HPP
+#define CURLHTTP_RESULT_T_HPP
+
+
+#include <system_error>
+
+#include "curl_error.hpp"
+#include "status_code.hpp"
+
+
+namespace curlhttp{
+
+    struct result_t{
+        std::error_code error;
+        status_code code{};
+
+        bool transfer_ok() const{
+            return !error;
+        }
+
+        bool http_ok() const{
+            return !is_client_error(code) && !is_server_error(code);
+        }
+
+        bool ok() const{
+            return transfer_ok() && http_ok();
+        }
+
+        explicit operator bool() const{
+            return ok();
+        }
+
+        std::error_code as_error_code() const{
+            if(error || http_ok())
+                return error;
+
+            return make_http_error_code(code);
+        }
+    };
+
+}
+
+
+#endif
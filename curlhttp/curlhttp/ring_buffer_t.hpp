@@ -0,0 +1,186 @@
+#ifndef CURLHTTP_RING_BUFFER_T_HPP
+#define CURLHTTP_RING_BUFFER_T_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+#include <curl/curl.h>
+
+#include "default_writer.hpp"
+#include "notifier_t.hpp"
+
+
+namespace curlhttp{
+
+    class ring_buffer_t{
+        friend struct default_writer<ring_buffer_t>;
+
+    public:
+        explicit ring_buffer_t(std::size_t capacity = 1 << 20)
+            : mask{round_up(std::max<std::size_t>(capacity, CURL_MAX_WRITE_SIZE)) - 1}, storage{std::make_unique<char[]>(mask + 1)} {}
+
+        ring_buffer_t(const ring_buffer_t& ) = delete;
+        ring_buffer_t& operator= (const ring_buffer_t& ) = delete;
+
+        std::size_t capacity() const{
+            return mask + 1;
+        }
+
+        std::size_t size() const{
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        bool empty() const{
+            return size() == 0;
+        }
+
+        std::size_t write(const char* data, std::size_t length){
+            std::size_t t = tail.load(std::memory_order_relaxed);
+
+            if(length > capacity() - (t - cached_head)){
+                cached_head = head.load(std::memory_order_acquire);
+
+                if(length > capacity() - (t - cached_head)){
+                    blocked.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    cached_head = head.load(std::memory_order_acquire);
+                }
+            }
+
+            std::size_t n = std::min(length, capacity() - (t - cached_head));
+            std::size_t offset = t & mask;
+            std::size_t first = std::min(n, capacity() - offset);
+
+            std::memcpy(storage.get() + offset, data, first);
+            std::memcpy(storage.get(), data + first, n - first);
+
+            if(n < length)
+                pending = std::min(length - n, capacity() / 2);
+
+            else{
+                pending = 0;
+                blocked.store(false, std::memory_order_relaxed);
+            }
+
+            tail.store(t + n, std::memory_order_release);
+            return n;
+        }
+
+        bool writable() const{
+            return capacity() - (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire)) >= pending;
+        }
+
+        void restart(){
+            pending = 0;
+            carried = 0;
+            blocked.store(false, std::memory_order_relaxed);
+            finished.store(false, std::memory_order_release);
+        }
+
+        void close(){
+            finished.store(true, std::memory_order_release);
+        }
+
+        bool closed() const{
+            return finished.load(std::memory_order_acquire);
+        }
+
+        bool eof() const{
+            return closed() && empty();
+        }
+
+        std::string_view peek(){
+            std::size_t h = head.load(std::memory_order_relaxed);
+
+            if(h == cached_tail)
+                cached_tail = tail.load(std::memory_order_acquire);
+
+            std::size_t offset = h & mask;
+            return {storage.get() + offset, std::min(cached_tail - h, capacity() - offset)};
+        }
+
+        void consume(std::size_t length){
+            head.store(head.load(std::memory_order_relaxed) + length, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if(blocked.load(std::memory_order_relaxed))
+                notifier();
+        }
+
+        void set_notifier(std::function<void()> fn){
+            notifier.set(std::move(fn));
+        }
+
+        std::size_t read(char* buffer, std::size_t length){
+            std::size_t nread{};
+
+            while(nread < length){
+                std::string_view chunk = peek();
+
+                if(chunk.empty())
+                    break;
+
+                std::size_t n = std::min(length - nread, chunk.size());
+                std::memcpy(buffer + nread, chunk.data(), n);
+
+                consume(n);
+                nread += n;
+            }
+
+            return nread;
+        }
+
+    private:
+        const std::size_t mask;
+        std::unique_ptr<char[]> storage;
+
+        alignas(64) std::atomic<std::size_t> head{};
+        std::size_t cached_tail{};
+
+        alignas(64) std::atomic<std::size_t> tail{};
+        std::size_t cached_head{};
+        std::size_t pending{}, carried{};
+
+        std::atomic<bool> finished{}, blocked{};
+        notifier_t notifier;
+
+        static std::size_t round_up(std::size_t n){
+            std::size_t result = 2;
+
+            while(result < n)
+                result <<= 1;
+
+            return result;
+        }
+    };
+
+
+    template<>
+    struct default_writer<ring_buffer_t>{
+        std::size_t operator()(ring_buffer_t& ring, const char* buffer, std::size_t size, std::size_t nmemb){
+            std::size_t buffer_size = size * nmemb;
+
+            // Paused data is delivered again from its start, possibly in smaller pieces,
+            // so skip the part already stored.
+            std::size_t skip = std::min(ring.carried, buffer_size);
+            std::size_t stored = skip + ring.write(buffer + skip, buffer_size - skip);
+
+            if(stored < buffer_size){
+                ring.carried = stored;
+                return CURL_WRITEFUNC_PAUSE;
+            }
+
+            ring.carried -= skip;
+            return buffer_size;
+        }
+    };
+
+}
+
+
+#endif
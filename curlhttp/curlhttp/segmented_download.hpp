@@ -0,0 +1,374 @@
+#ifndef CURLHTTP_SEGMENTED_DOWNLOAD_HPP
+#define CURLHTTP_SEGMENTED_DOWNLOAD_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_handle.hpp"
+#include "download_checkpoint_t.hpp"
+#include "file_t.hpp"
+#include "header_names.hpp"
+#include "http_request.hpp"
+
+
+namespace curlhttp{
+
+    struct segment_t{
+        file_t* file{};
+        curl_off_t begin{}, end{-1};
+        curl_off_t written{};
+        curl_off_t total{-1};
+        std::size_t attempts{};
+        bool done{};
+        std::function<void(std::size_t)> progress{};
+
+        curl_off_t length() const{
+            return end < 0 ? -1 : end - begin + 1;
+        }
+
+        bool complete() const{
+            return end < 0 ? total < 0 || begin + written == total : written == length();
+        }
+
+        std::string range() const{
+            return std::to_string(begin + written) + '-' + (end < 0 ? std::string{} : std::to_string(end));
+        }
+    };
+
+
+    template<>
+    struct default_writer<segment_t>{
+        std::size_t operator()(segment_t& segment, const char* buffer, std::size_t size, std::size_t nmemb){
+            std::size_t buffer_size = size * nmemb;
+
+            if(segment.end >= 0 && segment.written + (curl_off_t)buffer_size > segment.length())
+                return 0;
+
+            std::size_t n = segment.file->write_at(buffer, buffer_size, (std::uint64_t)(segment.begin + segment.written));
+            segment.written += (curl_off_t)n;
+
+            if(segment.progress)
+                segment.progress(n);
+
+            return n;
+        }
+    };
+
+
+    class segmented_download{
+    public:
+        using request_t = get_request<segment_t>;
+
+        url_t url;
+        std::filesystem::path path;
+        std::size_t connections{4};
+        curl_off_t min_segment_size{4 << 20};
+        std::size_t max_attempts{4};
+        std::chrono::milliseconds retry_delay{250};
+        std::vector<std::shared_ptr<basic_easy_option>> options;
+        bool resumable{};
+        curl_off_t checkpoint_interval{64 << 20};
+
+        segmented_download(const url_t& uri, const std::filesystem::path& p)
+            : url{uri}, path{p} {}
+
+        void perform(){
+            for(bool restarted{};; restarted = true){
+                probe();
+
+                bool resume = restore();
+                file = file_t{path, !resume};
+
+                if(!resume){
+                    if(content_length > 0)
+                        file.preallocate((std::uint64_t)content_length);
+
+                    split();
+                }
+
+                run();
+
+                if(!changed || restarted)
+                    break;
+
+                download_checkpoint_t::remove(checkpoint_path());
+            }
+
+            for(const auto& segment : segments){
+                if(!segment.done){
+                    checkpoint();
+                    throw curl_error{make_error_code(CURLE_PARTIAL_FILE), "Segmented download incomplete"};
+                }
+            }
+
+            if(content_length < 0)
+                file.resize((std::uint64_t)segments.front().written);
+
+            if(resumable)
+                download_checkpoint_t::remove(checkpoint_path());
+        }
+
+        std::filesystem::path checkpoint_path() const{
+            auto result = path;
+            result += ".checkpoint";
+            return result;
+        }
+
+        curl_off_t resumed() const{
+            return resumed_bytes;
+        }
+
+        curl_off_t size() const{
+            return content_length;
+        }
+
+        bool ranges_supported() const{
+            return accept_ranges;
+        }
+
+        const std::vector<segment_t>& get_segments() const{
+            return segments;
+        }
+
+    private:
+        struct deferred_t{
+            request_t* request;
+            std::chrono::steady_clock::time_point due;
+        };
+
+        file_t file;
+        std::vector<segment_t> segments;
+        std::vector<deferred_t> deferred;
+        curl_off_t content_length{-1};
+        std::string validator;
+        curl_off_t resumed_bytes{}, unsaved{};
+        bool accept_ranges{};
+        bool changed{};
+        bool checkpoint_due{};
+
+        void run(){
+            async_handle handle;
+            handle.set_throw_errors(false);
+
+            std::vector<std::unique_ptr<request_t>> requests;
+            changed = false;
+            checkpoint_due = false;
+            unsaved = 0;
+            deferred.clear();
+
+            handle.loop_callback = [this, &handle, &requests]{
+                if(changed){
+                    for(auto& request : requests)
+                        handle.remove(*request);
+
+                    deferred.clear();
+                    return;
+                }
+
+                if(checkpoint_due)
+                    checkpoint();
+
+                resubmit(handle);
+            };
+
+            for(auto& segment : segments){
+                segment.file = &file;
+                segment.attempts = 0;
+
+                if(resumable)
+                    segment.progress = [this](std::size_t n){
+                        if((unsaved += (curl_off_t)n) >= checkpoint_interval)
+                            checkpoint_due = true;
+                    };
+
+                if(segment.done)
+                    continue;
+
+                requests.push_back(std::make_unique<request_t>(segment, url));
+                auto& request = *requests.back();
+
+                prepare(request);
+                handle.add(request, [this](request_t& r){
+                    retry(r);
+                });
+            }
+
+            handle.perform();
+
+            while(deferred.size() && !changed){
+                std::this_thread::sleep_until(std::min_element(deferred.begin(), deferred.end(), [](const auto& a, const auto& b){
+                    return a.due < b.due;
+                })->due);
+
+                resubmit(handle);
+                handle.perform();
+            }
+        }
+
+        void resubmit(async_handle& handle){
+            auto now = std::chrono::steady_clock::now();
+
+            for(auto it = deferred.begin(); it != deferred.end();){
+                if(it->due > now){
+                    ++it;
+                    continue;
+                }
+
+                prepare(*it->request);
+                handle.reuse(*it->request);
+                it = deferred.erase(it);
+            }
+        }
+
+        bool restore(){
+            resumed_bytes = 0;
+
+            if(!resumable || !accept_ranges || validator.empty())
+                return false;
+
+            download_checkpoint_t saved;
+            std::error_code ec;
+            auto file_size = std::filesystem::file_size(path, ec);
+
+            if(!saved.load(checkpoint_path()) || saved.url != url.string() || saved.validator != validator ||
+               saved.size != content_length || ec || file_size < (std::uintmax_t)content_length){
+                download_checkpoint_t::remove(checkpoint_path());
+                return false;
+            }
+
+            segments.clear();
+
+            for(const auto& range : saved.ranges){
+                segment_t segment{&file, range.begin, range.end, range.written};
+
+                if(range.begin < 0 || range.end >= content_length || range.written < 0 || range.written > segment.length()){
+                    segments.clear();
+                    download_checkpoint_t::remove(checkpoint_path());
+                    return false;
+                }
+
+                segment.done = segment.complete();
+                resumed_bytes += range.written;
+                segments.push_back(std::move(segment));
+            }
+
+            return true;
+        }
+
+        void checkpoint(){
+            unsaved = 0;
+            checkpoint_due = false;
+
+            if(!resumable || !accept_ranges || validator.empty() || changed)
+                return;
+
+            download_checkpoint_t saved{url.string(), validator, content_length, {}};
+
+            for(const auto& segment : segments)
+                saved.ranges.push_back({segment.begin, segment.end, segment.written});
+
+            file.sync();
+            saved.save(checkpoint_path());
+        }
+
+        void probe(){
+            head_request request{url};
+
+            for(auto& opt : options)
+                request.set_option(opt);
+
+            request.throw_easy_errors = false;
+            request.throw_http_errors = false;
+            request.perform();
+
+            content_length = -1;
+            accept_ranges = false;
+            validator.clear();
+
+            if(!request.result().ok())
+                return;
+
+            const auto& headers = request.get_response_headers();
+            auto view = headers.back();
+            auto ranges = view.get(header_names::accept_ranges);
+            auto etag = view.get(header_names::etag);
+            auto modified = view.get(header_names::last_modified);
+
+            request.get_info(CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, content_length);
+            accept_ranges = ranges && ascii_icase_compare(*ranges, "bytes") && content_length > 0;
+
+            if(etag && etag->substr(0, 2) != "W/")
+                validator = *etag;
+            else if(modified)
+                validator = *modified;
+        }
+
+        void split(){
+            segments.clear();
+
+            if(!accept_ranges || content_length <= min_segment_size || connections < 2){
+                segments.push_back({&file, 0, accept_ranges ? content_length - 1 : -1});
+                segments.back().total = content_length;
+                return;
+            }
+
+            curl_off_t count = std::min<curl_off_t>((curl_off_t)connections, (content_length + min_segment_size - 1) / min_segment_size);
+            curl_off_t chunk = (content_length + count - 1) / count;
+
+            for(curl_off_t begin{}; begin < content_length; begin += chunk)
+                segments.push_back({&file, begin, std::min(begin + chunk, content_length) - 1});
+        }
+
+        void prepare(request_t& request){
+            auto& segment = request.rx_buffer;
+
+            for(auto& opt : options)
+                request.set_option(opt);
+
+            request.throw_easy_errors = false;
+            request.throw_http_errors = false;
+            request.throw_callback_exceptions = false;
+
+            if(accept_ranges){
+                request.set_option(CURLOPT_RANGE, segment.range().c_str());
+
+                if(validator.size())
+                    request.headers = {{"If-Range", validator}};
+
+                request.status_code_callback = [this](status_code code){
+                    if(code == status_code::ok)
+                        changed = true;
+
+                    return code == status_code::partial_content || is_redirection(code) || (int)code < 200;
+                };
+            }
+
+            ++segment.attempts;
+        }
+
+        void retry(request_t& request){
+            auto& segment = request.rx_buffer;
+            segment.done = request.result().ok() && segment.complete();
+
+            if(segment.done || changed || segment.attempts >= max_attempts)
+                return;
+
+            if(!accept_ranges)
+                segment.written = 0;
+
+            auto delay = retry_delay * (1 << std::min<std::size_t>(segment.attempts - 1, 5));
+            deferred.push_back({&request, std::chrono::steady_clock::now() + delay});
+        }
+    };
+
+}
+
+
+#endif
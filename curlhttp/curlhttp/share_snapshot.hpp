@@ -0,0 +1,221 @@
+#ifndef CURLHTTP_SHARE_SNAPSHOT_HPP
+#define CURLHTTP_SHARE_SNAPSHOT_HPP
+
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "curl_error.hpp"
+#include "file_t.hpp"
+#include "resolve_cache.hpp"
+
+
+namespace curlhttp{
+
+    struct share_snapshot_t{
+        static constexpr char magic[4] = {'C', 'H', 'S', 'S'};
+        static constexpr std::uint8_t version = 1;
+        static constexpr std::uint32_t max_string_size = 1 << 20;
+
+        struct ssl_session_t{
+            std::string key, hmac, data;
+            std::int64_t valid_until{};
+        };
+
+        std::vector<resolve_cache::entry_t> dns;
+        std::vector<std::string> cookies;
+        std::vector<ssl_session_t> ssl_sessions;
+
+        void clear(){
+            dns.clear();
+            cookies.clear();
+            ssl_sessions.clear();
+        }
+
+        void save(const std::filesystem::path& path) const{
+            auto temp = path;
+            temp += ".tmp";
+
+            {
+                std::ostringstream stream;
+
+                stream.write(magic, sizeof(magic));
+                write_integer(stream, version);
+
+                write_integer(stream, (std::uint8_t)section_t::dns);
+                write_integer(stream, (std::uint32_t)dns.size());
+
+                for(const auto& entry : dns){
+                    write_string(stream, entry.host);
+                    write_integer(stream, (std::uint16_t)entry.port);
+                    write_integer(stream, (std::uint32_t)entry.addresses.size());
+
+                    for(const auto& address : entry.addresses)
+                        write_string(stream, address);
+                }
+
+                write_integer(stream, (std::uint8_t)section_t::cookies);
+                write_integer(stream, (std::uint32_t)cookies.size());
+
+                for(const auto& cookie : cookies)
+                    write_string(stream, cookie);
+
+                write_integer(stream, (std::uint8_t)section_t::ssl_sessions);
+                write_integer(stream, (std::uint32_t)ssl_sessions.size());
+
+                for(const auto& session : ssl_sessions){
+                    write_string(stream, session.key);
+                    write_string(stream, session.hmac);
+                    write_string(stream, session.data);
+                    write_integer(stream, (std::uint64_t)session.valid_until);
+                }
+
+                write_integer(stream, (std::uint8_t)section_t::end);
+
+                std::string data = stream.str();
+                std::error_code ec;
+                file_t file;
+
+                std::filesystem::remove(temp, ec);
+                file.create_private(temp);
+
+                if(file.write_at(data.data(), data.size(), 0) != data.size())
+                    throw curl_error{make_error_code(CURLE_WRITE_ERROR), "Cannot write share snapshot"};
+
+                file.sync();
+            }
+
+            std::filesystem::rename(temp, path);
+        }
+
+        bool load(const std::filesystem::path& path){
+            std::ifstream stream{path, std::ios::binary};
+            char header[sizeof(magic)];
+            std::uint8_t v{}, section{};
+            std::uint32_t count{};
+
+            clear();
+
+            if(!stream.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic)
+                    || !read_integer(stream, v) || v != version)
+                return false;
+
+            while(read_integer(stream, section) && section != (std::uint8_t)section_t::end){
+                if(!read_integer(stream, count))
+                    break;
+
+                for(std::uint32_t n{}; n < count && stream; ++n){
+                    if(section == (std::uint8_t)section_t::dns){
+                        resolve_cache::entry_t entry;
+                        std::uint16_t port{};
+                        std::uint32_t naddresses{};
+
+                        read_string(stream, entry.host);
+                        read_integer(stream, port);
+                        read_integer(stream, naddresses);
+
+                        if(naddresses > max_string_size){
+                            clear();
+                            return false;
+                        }
+
+                        entry.port = port;
+                        entry.addresses.resize(naddresses);
+
+                        for(auto& address : entry.addresses)
+                            read_string(stream, address);
+
+                        dns.push_back(std::move(entry));
+                    }
+
+                    else if(section == (std::uint8_t)section_t::cookies){
+                        std::string cookie;
+                        read_string(stream, cookie);
+                        cookies.push_back(std::move(cookie));
+                    }
+
+                    else if(section == (std::uint8_t)section_t::ssl_sessions){
+                        ssl_session_t session;
+                        std::uint64_t valid_until{};
+
+                        read_string(stream, session.key);
+                        read_string(stream, session.hmac);
+                        read_string(stream, session.data);
+                        read_integer(stream, valid_until);
+
+                        session.valid_until = (std::int64_t)valid_until;
+                        ssl_sessions.push_back(std::move(session));
+                    }
+
+                    else{
+                        clear();
+                        return false;
+                    }
+                }
+            }
+
+            if(section != (std::uint8_t)section_t::end){
+                clear();
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        enum class section_t : std::uint8_t{
+            end, dns, cookies, ssl_sessions
+        };
+
+        template<typename T>
+        static void write_integer(std::ostream& stream, T value){
+            char buffer[sizeof(T)];
+
+            for(std::size_t n{}; n < sizeof(T); ++n)
+                buffer[n] = (char)((std::uint64_t)value >> (8 * n));
+
+            stream.write(buffer, sizeof(buffer));
+        }
+
+        template<typename T>
+        static bool read_integer(std::istream& stream, T& value){
+            unsigned char buffer[sizeof(T)];
+            std::uint64_t result{};
+
+            if(!stream.read((char*)buffer, sizeof(buffer)))
+                return false;
+
+            for(std::size_t n{}; n < sizeof(T); ++n)
+                result |= (std::uint64_t)buffer[n] << (8 * n);
+
+            value = (T)result;
+            return true;
+        }
+
+        static void write_string(std::ostream& stream, const std::string& s){
+            write_integer(stream, (std::uint32_t)s.size());
+            stream.write(s.data(), (std::streamsize)s.size());
+        }
+
+        static bool read_string(std::istream& stream, std::string& s){
+            std::uint32_t size{};
+
+            if(!read_integer(stream, size) || size > max_string_size){
+                stream.setstate(std::ios::failbit);
+                return false;
+            }
+
+            s.resize(size);
+            return (bool)stream.read(s.data(), size);
+        }
+    };
+
+}
+
+
+#endif
@@ -2,14 +2,25 @@
 #define SIZE_GETTER_HPP
 
 
+#include <cstddef>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 
+#include <curl/curl.h>
+
 #include "nullbuf_t.hpp"
 
 
 namespace curlhttp{
+    constexpr std::size_t unknown_size = (std::size_t)-1;
+
+
+    inline curl_off_t upload_size(std::size_t size){
+        return size == unknown_size ? -1 : (curl_off_t)size;
+    }
+
+
     template<typename T>
     struct size_getter;
 
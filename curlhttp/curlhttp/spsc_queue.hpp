@@ -0,0 +1,88 @@
+#ifndef CURLHTTP_SPSC_QUEUE_HPP
+#define CURLHTTP_SPSC_QUEUE_HPP
+
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+
+namespace curlhttp{
+
+    template<typename T>
+    class spsc_queue{
+    public:
+        explicit spsc_queue(std::size_t capacity)
+            : mask{round_up(capacity) - 1}, slots{std::make_unique<T[]>(mask + 1)} {}
+
+        spsc_queue(const spsc_queue& ) = delete;
+        spsc_queue& operator= (const spsc_queue& ) = delete;
+
+        std::size_t capacity() const{
+            return mask + 1;
+        }
+
+        bool empty() const{
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+
+        std::size_t size() const{
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        template<typename U>
+        bool try_push(U&& value){
+            std::size_t t = tail.load(std::memory_order_relaxed);
+
+            if(t - cached_head > mask){
+                cached_head = head.load(std::memory_order_acquire);
+
+                if(t - cached_head > mask)
+                    return false;
+            }
+
+            slots[t & mask] = std::forward<U>(value);
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(T& value){
+            std::size_t h = head.load(std::memory_order_relaxed);
+
+            if(h == cached_tail){
+                cached_tail = tail.load(std::memory_order_acquire);
+
+                if(h == cached_tail)
+                    return false;
+            }
+
+            value = std::move(slots[h & mask]);
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        const std::size_t mask;
+        std::unique_ptr<T[]> slots;
+
+        alignas(64) std::atomic<std::size_t> head{};
+        std::size_t cached_tail{};
+
+        alignas(64) std::atomic<std::size_t> tail{};
+        std::size_t cached_head{};
+
+        static std::size_t round_up(std::size_t n){
+            std::size_t result = 2;
+
+            while(result < n)
+                result <<= 1;
+
+            return result;
+        }
+    };
+
+}
+
+
+#endif
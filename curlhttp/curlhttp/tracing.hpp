@@ -0,0 +1,308 @@
+#ifndef CURLHTTP_TRACING_HPP
+#define CURLHTTP_TRACING_HPP
+
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "curl_error.hpp"
+#include "spsc_queue.hpp"
+#include "status_code.hpp"
+#include "transfer_info_t.hpp"
+
+
+namespace curlhttp{
+
+    struct trace_context_t{
+        static constexpr std::size_t traceparent_size = 55;
+
+        std::array<std::uint8_t, 16> trace_id{};
+        std::array<std::uint8_t, 8> span_id{};
+        std::uint8_t flags{1};
+
+        bool valid() const{
+            return !is_zero(trace_id) && !is_zero(span_id);
+        }
+
+        bool sampled() const{
+            return flags & 1;
+        }
+
+        trace_context_t child() const{
+            trace_context_t result{*this};
+            fill_random(result.span_id);
+            return result;
+        }
+
+        void format(char* out) const{
+            out[0] = '0';
+            out[1] = '0';
+            out[2] = '-';
+            out = write_hex(out + 3, trace_id);
+            *out = '-';
+            out = write_hex(out + 1, span_id);
+            *out = '-';
+            out = write_hex(out + 1, std::array<std::uint8_t, 1>{flags});
+            *out = '\0';
+        }
+
+        std::string traceparent() const{
+            char buffer[traceparent_size + 1];
+            format(buffer);
+            return buffer;
+        }
+
+        static trace_context_t generate(){
+            trace_context_t result;
+
+            fill_random(result.trace_id);
+            fill_random(result.span_id);
+
+            return result;
+        }
+
+        static std::optional<trace_context_t> parse(std::string_view s){
+            trace_context_t result;
+            std::array<std::uint8_t, 1> flags;
+
+            if(s.size() < 55 || s.substr(0, 3) != "00-" || s[35] != '-' || s[52] != '-'
+                    || !parse_hex(s.substr(3, 32), result.trace_id)
+                    || !parse_hex(s.substr(36, 16), result.span_id)
+                    || !parse_hex(s.substr(53, 2), flags))
+                return {};
+
+            result.flags = flags[0];
+
+            if(!result.valid())
+                return {};
+
+            return result;
+        }
+
+    private:
+        template<std::size_t N>
+        static bool is_zero(const std::array<std::uint8_t, N>& a){
+            for(auto b : a){
+                if(b)
+                    return false;
+            }
+
+            return true;
+        }
+
+        template<std::size_t N>
+        static void fill_random(std::array<std::uint8_t, N>& a){
+            thread_local std::mt19937_64 engine{std::random_device{}()};
+
+            do{
+                for(std::size_t n{}; n < N; n += 8){
+                    std::uint64_t v = engine();
+
+                    for(std::size_t k{}; k < 8 && n + k < N; ++k)
+                        a[n + k] = (std::uint8_t)(v >> (8 * k));
+                }
+            } while(is_zero(a));
+        }
+
+        template<std::size_t N>
+        static char* write_hex(char* out, const std::array<std::uint8_t, N>& a){
+            constexpr char digits[] = "0123456789abcdef";
+
+            for(auto b : a){
+                *out++ = digits[b >> 4];
+                *out++ = digits[b & 15];
+            }
+
+            return out;
+        }
+
+        template<std::size_t N>
+        static bool parse_hex(std::string_view s, std::array<std::uint8_t, N>& a){
+            auto digit = [](char c) -> int{
+                if(c >= '0' && c <= '9')
+                    return c - '0';
+
+                if(c >= 'a' && c <= 'f')
+                    return c - 'a' + 10;
+
+                return -1;
+            };
+
+            for(std::size_t n{}; n < N; ++n){
+                int hi = digit(s[2 * n]), lo = digit(s[2 * n + 1]);
+
+                if(hi < 0 || lo < 0)
+                    return false;
+
+                a[n] = (std::uint8_t)(hi << 4 | lo);
+            }
+
+            return true;
+        }
+    };
+
+
+    struct traceparent_header_t{
+        static constexpr std::size_t prefix_size = sizeof("traceparent: ") - 1;
+
+        char line[prefix_size + trace_context_t::traceparent_size + 1]{"traceparent: "};
+        curl_slist node{};
+    };
+
+
+    struct span_event_t{
+        const char* name{};
+        std::chrono::microseconds offset{};
+    };
+
+
+    struct span_t{
+        using clock_type = std::chrono::system_clock;
+
+        trace_context_t context;
+        std::optional<trace_context_t> parent;
+        std::string name, url;
+        status_code code{};
+        CURLcode result{};
+        clock_type::time_point start, end;
+        std::vector<span_event_t> events;
+
+        std::chrono::microseconds duration() const{
+            return std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        }
+
+        void add_events(const transfer_info_t& info){
+            auto queued = std::chrono::duration_cast<std::chrono::microseconds>(duration() - std::chrono::microseconds{info.total_time});
+
+            if(queued.count() < 0)
+                queued = {};
+
+            events.push_back({"queued", {}});
+            add_event("dns", queued, info.namelookup_time);
+            add_event("connect", queued, info.connect_time);
+            add_event("tls", queued, info.appconnect_time);
+            add_event("request_sent", queued, info.pretransfer_time);
+            add_event("first_byte", queued, info.starttransfer_time);
+            add_event("complete", queued, info.total_time);
+        }
+
+    private:
+        void add_event(const char* event, std::chrono::microseconds queued, curl_off_t at){
+            if(at > 0)
+                events.push_back({event, queued + std::chrono::microseconds{at}});
+        }
+    };
+
+
+    class span_exporter{
+    public:
+        virtual ~span_exporter() {}
+
+        virtual void export_span(const span_t& span) = 0;
+        virtual void flush() {}
+    };
+
+
+    class tracer{
+    public:
+        std::optional<trace_context_t> parent;
+
+        explicit tracer(std::shared_ptr<span_exporter> exp, std::size_t capacity = 1024,
+                        std::chrono::milliseconds poll = std::chrono::milliseconds{5})
+            : exporter{checked(std::move(exp))}, queue{capacity}, poll_interval{poll},
+              worker{&tracer::run, this} {}
+
+        tracer(const tracer& ) = delete;
+        tracer& operator= (const tracer& ) = delete;
+
+        ~tracer(){
+            stopped.store(true, std::memory_order_release);
+            worker.join();
+        }
+
+        trace_context_t start() const{
+            return parent ? parent->child() : trace_context_t::generate();
+        }
+
+        bool submit(span_t&& span){
+            if(queue.try_push(std::move(span)))
+                return true;
+
+            dropped_spans.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        std::uint64_t dropped() const{
+            return dropped_spans.load(std::memory_order_relaxed);
+        }
+
+        std::uint64_t export_failures() const{
+            return failed_exports.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::shared_ptr<span_exporter> exporter;
+        spsc_queue<span_t> queue;
+        std::chrono::milliseconds poll_interval;
+        std::atomic<bool> stopped{};
+        std::atomic<std::uint64_t> dropped_spans{}, failed_exports{};
+        std::thread worker;
+
+        static std::shared_ptr<span_exporter> checked(std::shared_ptr<span_exporter> exp){
+            if(!exp)
+                throw curl_error{make_error_code(CURLE_BAD_FUNCTION_ARGUMENT), "Tracer requires a span exporter"};
+
+            return exp;
+        }
+
+        void run(){
+            span_t span;
+
+            for(;;){
+                bool stop = stopped.load(std::memory_order_acquire);
+                bool exported{};
+
+                while(queue.try_pop(span)){
+                    try{
+                        exporter->export_span(span);
+                        exported = true;
+                    }
+
+                    catch(...){
+                        failed_exports.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                if(exported){
+                    try{
+                        exporter->flush();
+                    }
+
+                    catch(...){
+                        failed_exports.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                if(stop)
+                    break;
+
+                std::this_thread::sleep_for(poll_interval);
+            }
+        }
+    };
+
+}
+
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef CURLHTTP_TRANSFER_INFO_T_HPP
+#define CURLHTTP_TRANSFER_INFO_T_HPP
+
+
+#include <string>
+#include <curl/curl.h>
+
+
+namespace curlhttp{
+
+    struct transfer_info_t{
+        std::string method;
+        long response_code{};
+
+        curl_off_t namelookup_time{};
+        curl_off_t connect_time{};
+        curl_off_t appconnect_time{};
+        curl_off_t pretransfer_time{};
+        curl_off_t starttransfer_time{};
+        curl_off_t total_time{};
+        curl_off_t redirect_time{};
+
+        curl_off_t bytes_downloaded{};
+        curl_off_t bytes_uploaded{};
+        long redirect_count{};
+        long num_connects{};
+        long http_version{};
+        curl_off_t connection_id{-1};
+
+        bool connected() const{
+            return connect_time > 0 || pretransfer_time > 0;
+        }
+
+        bool reused_connection() const{
+            return connected() && !num_connects;
+        }
+
+        void clear(){
+            *this = transfer_info_t{};
+        }
+
+        void collect(CURL* handle){
+            char* m{};
+
+            if(curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_METHOD, &m) == CURLE_OK && m)
+                method = m;
+            else
+                method.clear();
+
+            curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
+
+            curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME_T, &namelookup_time);
+            curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME_T, &connect_time);
+            curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME_T, &appconnect_time);
+            curl_easy_getinfo(handle, CURLINFO_PRETRANSFER_TIME_T, &pretransfer_time);
+            curl_easy_getinfo(handle, CURLINFO_STARTTRANSFER_TIME_T, &starttransfer_time);
+            curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME_T, &total_time);
+            curl_easy_getinfo(handle, CURLINFO_REDIRECT_TIME_T, &redirect_time);
+
+            curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD_T, &bytes_downloaded);
+            curl_easy_getinfo(handle, CURLINFO_SIZE_UPLOAD_T, &bytes_uploaded);
+            curl_easy_getinfo(handle, CURLINFO_REDIRECT_COUNT, &redirect_count);
+            curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &num_connects);
+            curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &http_version);
+
+#if LIBCURL_VERSION_NUM >= 0x080200
+            if(curl_easy_getinfo(handle, CURLINFO_CONN_ID, &connection_id) != CURLE_OK)
+                connection_id = -1;
+#else
+            long local_port{};
+
+            if(curl_easy_getinfo(handle, CURLINFO_LOCAL_PORT, &local_port) == CURLE_OK && local_port)
+                connection_id = local_port;
+            else
+                connection_id = -1;
+#endif
+        }
+    };
+
+}
+
+
+#endif
@@ -2,14 +2,17 @@
 #define CURLHTTP_URL_T_HPP
 
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <optional>
+#include <string_view>
 
 #include "detail.hpp"
 #include "curl_error.hpp"
 #include "path_t.hpp"
 #include "query_t.hpp"
+#include "utility.hpp"
 
 
 namespace curlhttp{
@@ -116,28 +119,41 @@ namespace curlhttp{
         }
 
         query_t query(int flags = 0) const{
-            if(auto p = get(CURLUPART_QUERY, flags)){
-                std::string s = *p + '&';
-                std::size_t beg{}, pos{};
-                field_t field;
-                query_t query;
+            query_t query;
 
-                while((pos = s.find('&', pos)) != s.npos){
-                    std::string sub = s.substr(beg, pos - beg);
+            if(auto p = get(CURLUPART_QUERY, flags & ~CURLU_URLDECODE)){
+                std::string_view s{*p};
 
-                    if(!sub.size())
-                        break;
+                while(s.size()){
+                    std::size_t pos = std::min(s.find('&'), s.size());
+                    std::string_view sub = s.substr(0, pos);
+                    std::size_t eq = sub.find('=');
 
-                    field.parse_query(sub);
-                    beg = ++pos;
+                    s.remove_prefix(std::min(pos + 1, s.size()));
+
+                    if(sub.empty())
+                        continue;
+
+                    if(eq == sub.npos)
+                        throw curl_error{make_error_code(CURLE_READ_ERROR), "Cannot parse query"};
+
+                    field_t field;
+
+                    if(flags & CURLU_URLDECODE){
+                        unescape(field.name, sub.substr(0, eq));
+                        unescape(field.value, sub.substr(eq + 1));
+                    }
+
+                    else{
+                        field.name = sub.substr(0, eq);
+                        field.value = sub.substr(eq + 1);
+                    }
 
                     query.push_back(std::move(field));
                 }
-
-                return query;
             }
 
-            return query_t{};
+            return query;
         }
 
         std::string fragment(int flags = 0) const{
@@ -4,51 +4,165 @@
 
 #include <locale>
 #include <algorithm>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 #include <curl/curl.h>
 
 #include "field_t.hpp"
+#include "percent_encoding.hpp"
 #include "query_t.hpp"
 
 
 namespace curlhttp{
 
-    inline std::string escape(const std::string& s){
-        char* p = curl_easy_escape(nullptr, s.c_str(), (int)s.size());
-        std::string result{p};
-        curl_free(p);
+    inline void escape(std::string& out, std::string_view s, percent_mode_t mode = percent_mode_t::url){
+        std::size_t offset = out.size();
+        out.resize(offset + s.size() * 3);
+        out.resize(offset + percent_encode(out.data() + offset, s.data(), s.size(), mode));
+    }
+
+
+    inline void unescape(std::string& out, std::string_view s, percent_mode_t mode = percent_mode_t::url){
+        std::size_t offset = out.size();
+        out.resize(offset + s.size());
+        out.resize(offset + percent_decode(out.data() + offset, s.data(), s.size(), mode));
+    }
+
+
+    inline std::string escape(std::string_view s){
+        std::string result;
+        escape(result, s);
         return result;
     }
 
 
-    inline std::string unescape(const std::string& s){
-        int length;
-        char* p = curl_easy_unescape(nullptr, s.c_str(), (int)s.size(), &length);
-        std::string result{p};
-        curl_free(p);
-        result.resize(length);
+    inline std::string unescape(std::string_view s){
+        std::string result;
+        unescape(result, s);
         return result;
     }
 
 
-    inline bool icase_compare(const std::string& s1, const std::string& s2, const std::locale& loc = std::locale{}){
+    constexpr char ascii_tolower(char c){
+        return c >= 'A' && c <= 'Z' ? (char)(c | 0x20) : c;
+    }
+
+
+    inline bool ascii_icase_compare(std::string_view s1, std::string_view s2){
+        if(s1.size() != s2.size())
+            return false;
+
+        std::size_t n{};
+
+#ifdef CURLHTTP_SSE2
+        const __m128i upper_a = _mm_set1_epi8('A' - 1);
+        const __m128i upper_z = _mm_set1_epi8('Z' + 1);
+        const __m128i bit = _mm_set1_epi8(0x20);
+
+        auto fold = [&](__m128i v){
+            __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, upper_a), _mm_cmplt_epi8(v, upper_z));
+            return _mm_or_si128(v, _mm_and_si128(upper, bit));
+        };
+
+        for(; n + 16 <= s1.size(); n += 16){
+            __m128i v1 = fold(_mm_loadu_si128((const __m128i*)(s1.data() + n)));
+            __m128i v2 = fold(_mm_loadu_si128((const __m128i*)(s2.data() + n)));
+
+            if(_mm_movemask_epi8(_mm_cmpeq_epi8(v1, v2)) != 0xffff)
+                return false;
+        }
+#endif
+
+        for(; n < s1.size(); ++n){
+            if(ascii_tolower(s1[n]) != ascii_tolower(s2[n]))
+                return false;
+        }
+
+        return true;
+    }
+
+
+    inline bool icase_compare(std::string_view s1, std::string_view s2){
+        return ascii_icase_compare(s1, s2);
+    }
+
+
+    inline bool icase_compare(const std::string& s1, const std::string& s2, const std::locale& loc){
         return std::equal(s1.begin(), s1.end(), s2.begin(), s2.end(), [&loc](char c1, char c2){
             return std::toupper(c1, loc) == std::toupper(c2, loc);
         });
     }
 
 
+    constexpr std::uint32_t header_hash(std::string_view name){
+        std::uint32_t hash = 2166136261u;
+
+        for(char c : name)
+            hash = (hash ^ (std::uint8_t)ascii_tolower(c)) * 16777619u;
+
+        return hash;
+    }
+
+
+
+
+
+    inline std::string& encode_fields(std::string& out, const std::vector<field_t>& fields, percent_mode_t mode){
+        std::size_t size{};
+
+        for(const auto& field : fields)
+            size += (field.name.size() + field.value.size()) * 3 + 2;
+
+        out.clear();
+        out.reserve(size);
+
+        for(const auto& field : fields){
+            if(out.size())
+                out += '&';
+
+            escape(out, field.name, mode);
+            out += '=';
+            escape(out, field.value, mode);
+        }
+
+        return out;
+    }
+
+
+    // Fields are joined as given: callers pass already-encoded names and values.
     inline std::string query_string(const std::vector<field_t>& fields){
-        std::string s;
+        std::size_t size{};
 
         for(const auto& field : fields)
-            s += field.name + '=' + field.value + '&';
+            size += field.name.size() + field.value.size() + 2;
+
+        std::string result;
+        result.reserve(size);
+
+        for(const auto& field : fields){
+            if(result.size())
+                result += '&';
+
+            result += field.name;
+            result += '=';
+            result += field.value;
+        }
+
+        return result;
+    }
+
+
+    inline void form_encode(std::string& out, std::string_view s){
+        escape(out, s, percent_mode_t::form);
+    }
 
-        if(s.size())
-            s.pop_back();
 
-        return s;
+    inline std::string& form_encode(std::string& out, const std::vector<field_t>& fields){
+        return encode_fields(out, fields, percent_mode_t::form);
     }
 
 